@@ -1,16 +1,293 @@
 // Copyright (c) 2018-present The Alive2 Authors.
 // Distributed under the MIT license that can be found in the LICENSE file.
 
-#include "cache.h"
+#include "cache/cache.h"
+#include "util/config.h"
 #include "util/crc.h"
 #include "util/version.h"
+#include <algorithm>
 #include <cassert>
-#include <hiredis/hiredis.h>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifndef NO_REDIS_SUPPORT
+# include <hiredis/hiredis.h>
+#endif
 
 using namespace std;
+using namespace util;
+namespace fs = std::filesystem;
 
+// only the options that change what is being checked; e.g., a bigger
+// timeout can't make a correct transformation incorrect
+static string options() {
+  stringstream ss;
+  ss << config::disable_poison_input << config::disable_undef_input
+     << config::tgt_is_asm << config::check_if_src_is_ub
+     << config::disallow_ub_exploitation << ' ' << config::src_unroll_cnt
+     << ' ' << config::tgt_unroll_cnt << ' ' << config::max_offset_bits
+     << ' ' << config::max_sizet_bits;
+  return std::move(ss).str();
+}
+
+Hash128 Cache::getKey(const string &transform) {
+  return hash128(transform + '\0' + options());
+}
+
+string Cache::fingerprint() {
+  return string(alive_version) + ' ' + options();
+}
+
+template <typename T>
+static T read_at(const char *p) {
+  T v;
+  memcpy(&v, p, sizeof(T));
+  return v;
+}
+
+template <typename T>
+static void write_at(string &s, size_t offset, T v) {
+  memcpy(s.data() + offset, &v, sizeof(T));
+}
+
+/*
+ * u8 verdict, 3 bytes of padding, f32 time, u32 timeout, u32 length of the
+ * fingerprint, the fingerprint, the details (until the end)
+ */
+static constexpr size_t entry_header_size = 16;
+
+string CacheEntry::serialize() const {
+  string data(entry_header_size, '\0');
+  write_at(data, 0, (uint8_t)verdict);
+  write_at(data, 4, time);
+  write_at(data, 8, (uint32_t)timeout);
+  write_at(data, 12, (uint32_t)fingerprint.size());
+  data += fingerprint;
+  data += details;
+  return data;
+}
+
+optional<CacheEntry> CacheEntry::deserialize(string_view data) {
+  if (data.size() < entry_header_size ||
+      data.size() - entry_header_size < read_at<uint32_t>(data.data() + 12) ||
+      data[0] == Seen || (uint8_t)data[0] > Error)
+    return {};
+
+  CacheEntry entry;
+  entry.verdict = (Verdict)data[0];
+  entry.time    = read_at<float>(data.data() + 4);
+  entry.timeout = read_at<uint32_t>(data.data() + 8);
+  data.remove_prefix(entry_header_size);
+  size_t fingerprint_size = read_at<uint32_t>(data.data() - 4);
+  entry.fingerprint = data.substr(0, fingerprint_size);
+  entry.details     = data.substr(fingerprint_size);
+  return entry;
+}
+
+
+/*
+ * Layout of the file (in the machine's endianness; the file is local):
+ *  header: "ALIVE2C\2", u32 length of the version string, the version of
+ *          Alive2 that created the file, padding up to a multiple of 8
+ *  record: u32 magic, u32 length of the entry, u64 CRC of the rest of
+ *          the record, u64 key.lo, u64 key.hi, the serialized entry,
+ *          padding up to a multiple of 8
+ */
+static const char file_magic[8] = { 'A', 'L', 'I', 'V', 'E', '2', 'C', 2 };
+static constexpr uint32_t record_magic = 0xa11fe2c0;
+static constexpr size_t record_header_size = 32;
+
+static size_t align8(size_t n) {
+  return (n + 7) & ~size_t(7);
+}
+
+static crc_t record_crc(const char *record, size_t size) {
+  return crc_finalize(crc_update(crc_init(), record + 16, size - 16));
+}
+
+DiskCache::DiskCache(const string &path, bool allow_version_mismatch)
+  : path(path) {
+  error_code ec;
+  auto dir = fs::path(path).parent_path();
+  if (!dir.empty())
+    fs::create_directories(dir, ec);
+
+  fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    error("can't open the file");
+    return;
+  }
+
+  if (!lockFile(true))
+    return;
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    error("can't stat the file");
+    return;
+  }
+  if (st.st_size == 0) {
+    string header(file_magic, sizeof(file_magic));
+    uint32_t len = strlen(alive_version);
+    header.append((const char*)&len, sizeof(len));
+    header += alive_version;
+    header.resize(align8(header.size()), '\0');
+    if (write(fd, header.data(), header.size()) != (ssize_t)header.size()) {
+      error("can't write to the file");
+      return;
+    }
+  }
+  if (!lockFile(false) || !update())
+    return;
+
+  string_view version(map + 12, read_at<uint32_t>(map + 8));
+  if (version != alive_version) {
+    cerr << "Cache version mismatch!\n"
+            "This version of Alive2 is " << alive_version << "\n"
+            "But the cache was created by version " << version << '\n';
+    if (!allow_version_mismatch)
+      error("not using it");
+  }
+}
+
+DiskCache::~DiskCache() {
+  if (map)
+    munmap((void*)map, map_size);
+  if (fd >= 0)
+    close(fd);
+}
+
+string DiskCache::defaultPath() {
+  fs::path dir;
+  if (auto *xdg = getenv("XDG_CACHE_HOME"); xdg && *xdg)
+    dir = xdg;
+  else if (auto *home = getenv("HOME"); home && *home)
+    dir = fs::path(home) / ".cache";
+  else
+    dir = fs::temp_directory_path();
+  return (dir / "alive2" / "results").string();
+}
+
+// disables the cache; errors are not fatal as it's only an optimization
+bool DiskCache::error(const char *msg) {
+  cerr << "Alive2: cache " << path << ": " << msg << '\n';
+  if (map)
+    munmap((void*)map, map_size);
+  if (fd >= 0)
+    close(fd); // also releases the lock
+  map = nullptr;
+  map_size = 0;
+  fd = -1;
+  index.clear();
+  return false;
+}
+
+bool DiskCache::lockFile(bool lock) {
+  // a POSIX lock, which is per process, so it works across fork()
+  struct flock fl = {};
+  fl.l_type = lock ? F_WRLCK : F_UNLCK;
+  fl.l_whence = SEEK_SET;
+  while (fcntl(fd, F_SETLKW, &fl) == -1) {
+    if (errno != EINTR)
+      return error("can't lock the file");
+  }
+  return true;
+}
+
+/*
+ * map whatever was appended to the file since the last time (possibly by
+ * other processes) and index the new records. stops at the first record
+ * that is incomplete or corrupted: either it is still being written, or
+ * its writer crashed and it will be overwritten by the next store()
+ */
+bool DiskCache::update() {
+  struct stat st;
+  if (fstat(fd, &st) != 0)
+    return error("can't stat the file");
+
+  // the file never shrinks, so the mapped part stays valid
+  size_t size = st.st_size;
+  if (size > map_size) {
+    if (map)
+      munmap((void*)map, map_size);
+    void *p = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+      map = nullptr;
+      return error("can't map the file");
+    }
+    map = (const char*)p;
+    map_size = size;
+  }
+
+  if (scanned == 0) {
+    if (map_size < 12 || memcmp(map, file_magic, sizeof(file_magic)) ||
+        12 + read_at<uint32_t>(map + 8) > map_size)
+      return error("not a cache file");
+    scanned = align8(12 + read_at<uint32_t>(map + 8));
+  }
+
+  while (scanned + record_header_size <= map_size) {
+    const char *p = map + scanned;
+    size_t size = record_header_size + align8(read_at<uint32_t>(p + 4));
+    if (read_at<uint32_t>(p) != record_magic ||
+        scanned + size > map_size ||
+        record_crc(p, size) != read_at<uint64_t>(p + 8))
+      break;
+    index[{ read_at<uint64_t>(p + 16), read_at<uint64_t>(p + 24) }] = scanned;
+    scanned += size;
+  }
+  return true;
+}
+
+optional<CacheEntry> DiskCache::lookup(const Hash128 &key) {
+  lock_guard lock(mutex);
+  if (fd < 0 || !update())
+    return {};
+
+  auto I = index.find(key);
+  if (I == index.end())
+    return {};
+
+  const char *p = map + I->second;
+  return CacheEntry::deserialize({ p + record_header_size,
+                                   read_at<uint32_t>(p + 4) });
+}
+
+void DiskCache::store(const Hash128 &key, const CacheEntry &entry) {
+  string data = entry.serialize();
+  string record(record_header_size + align8(data.size()), '\0');
+  write_at(record, 0, record_magic);
+  write_at(record, 4, (uint32_t)data.size());
+  write_at(record, 16, key.lo);
+  write_at(record, 24, key.hi);
+  memcpy(record.data() + record_header_size, data.data(), data.size());
+  write_at(record, 8, (uint64_t)record_crc(record.data(), record.size()));
+
+  lock_guard lock(mutex);
+  if (fd < 0 || !lockFile(true))
+    return;
+
+  // append after the records of other processes
+  if (!update())
+    return;
+  if (pwrite(fd, record.data(), record.size(), scanned) !=
+      (ssize_t)record.size()) {
+    error("can't write to the file");
+    return;
+  }
+  if (lockFile(false))
+    update();
+}
+
+
+#ifndef NO_REDIS_SUPPORT
 static const char* redis_reply_string(int reply_type) {
   switch (reply_type) {
   case REDIS_REPLY_STRING:
@@ -43,7 +320,7 @@ static bool remote_get(const string &key, string &value, redisContext *ctx) {
     return false;
   } else if (reply->type == REDIS_REPLY_STRING) {
     // found
-    value = reply->str;
+    value.assign(reply->str, reply->len);
     freeReplyObject(reply);
     return true;
   } else {
@@ -69,37 +346,41 @@ static void remote_set(const string &key, const string &value, redisContext *ctx
   freeReplyObject(reply);
 }
 
-static crc_t string_crc(const string &s) {
-  return crc_finalize(crc_update(crc_init(), s.data(), s.size()));
-}
-
-bool Cache::lookup(const string &s) {
-  static const string default_value("XXX");
-  // Alive IR is bulky, so send a hash of it over to the cache. If
-  // this still uses too much RAM, the next step will be to use a
-  // Bloom filter
-  string remote_data, crc_string = to_string(string_crc(s));
-  if (remote_get(crc_string, remote_data, ctx)) {
-    assert(remote_data == default_value);
-    return true;
-  } else {
-    remote_set(crc_string, default_value, ctx);
-    return false;
+// queues a command in the output buffer; it's sent by the next get_reply()
+static void append_command(const vector<string> &args, redisContext *ctx) {
+  vector<const char*> argv;
+  vector<size_t> argvlen;
+  for (auto &arg : args) {
+    argv.emplace_back(arg.data());
+    argvlen.emplace_back(arg.size());
+  }
+  if (redisAppendCommandArgv(ctx, argv.size(), argv.data(), argvlen.data())
+        != REDIS_OK) {
+    cerr << "Redis error in append_command: " << ctx->errstr << "\n";
+    exit(-1);
   }
 }
 
-Cache::Cache(unsigned port, bool allow_version_mismatch) {
-  const char *hostname = "127.0.0.1";
-  struct timeval timeout = {1, 500000}; // 1.5 seconds
-  ctx = redisConnectWithTimeout(hostname, port, timeout);
-  if (!ctx) {
-    cerr << "Can't allocate redis context\n";
+static redisReply* get_reply(const char *cmd, int type, redisContext *ctx) {
+  void *reply = nullptr;
+  if (redisGetReply(ctx, &reply) != REDIS_OK || !reply) {
+    cerr << "Redis error in " << cmd << ": " << ctx->errstr << "\n";
     exit(-1);
   }
-  if (ctx->err) {
-    cerr << "Redis connection error: " << ctx->errstr << '\n';
+  auto *r = (redisReply *)reply;
+  if (r->type != type) {
+    cerr << "Redis protocol error in " << cmd << ", didn't expect reply type "
+         << redis_reply_string(r->type) << "\n";
     exit(-1);
   }
+  return r;
+}
+
+static constexpr size_t max_keys_per_command = 1024;
+
+RedisCache::RedisCache(unsigned port, bool allow_version_mismatch)
+  : port(port) {
+  connect();
   string version;
   if (remote_get("Alive2_version", version, ctx)) {
     if (version != util::alive_version) {
@@ -114,6 +395,115 @@ Cache::Cache(unsigned port, bool allow_version_mismatch) {
   }
 }
 
-Cache::~Cache() {
+RedisCache::~RedisCache() {
+  flush();
   redisFree(ctx);
 }
+
+void RedisCache::connect() {
+  if (ctx && pid == getpid())
+    return;
+
+  if (ctx) {
+    // inherited from the parent through fork(); the socket is still in use
+    // by the parent, and so are the stores it has buffered
+    redisFree(ctx);
+    pending_stores.clear();
+  }
+
+  const char *hostname = "127.0.0.1";
+  struct timeval timeout = {1, 500000}; // 1.5 seconds
+  ctx = redisConnectWithTimeout(hostname, port, timeout);
+  if (!ctx) {
+    cerr << "Can't allocate redis context\n";
+    exit(-1);
+  }
+  if (ctx->err) {
+    cerr << "Redis connection error: " << ctx->errstr << '\n';
+    exit(-1);
+  }
+  pid = getpid();
+}
+
+optional<CacheEntry> RedisCache::lookup(const Hash128 &key) {
+  lock_guard lock(mutex);
+  auto [I, inserted] = prefetched.try_emplace(key);
+  if (inserted) {
+    // Alive IR is bulky, so send a hash of it over to the cache. If
+    // this still uses too much RAM, the next step will be to use a
+    // Bloom filter
+    connect();
+    string remote_data;
+    if (remote_get(key.str(), remote_data, ctx))
+      I->second = CacheEntry::deserialize(remote_data);
+  }
+  return I->second;
+}
+
+void RedisCache::store(const Hash128 &key, const CacheEntry &entry) {
+  lock_guard lock(mutex);
+  connect();
+  prefetched[key] = entry;
+  pending_stores.emplace_back(key, entry.serialize());
+  if (pending_stores.size() >= max_keys_per_command)
+    sendStores();
+}
+
+void RedisCache::prefetch(const vector<Hash128> &keys) {
+  lock_guard lock(mutex);
+  connect();
+
+  vector<Hash128> todo;
+  for (auto &key : keys) {
+    if (!prefetched.count(key))
+      todo.emplace_back(key);
+  }
+
+  // send all the MGETs before reading any reply
+  for (size_t i = 0; i < todo.size(); i += max_keys_per_command) {
+    vector<string> args = { "MGET" };
+    for (size_t j = i; j < min(todo.size(), i + max_keys_per_command); ++j)
+      args.emplace_back(todo[j].str());
+    append_command(args, ctx);
+  }
+
+  for (size_t i = 0; i < todo.size(); i += max_keys_per_command) {
+    auto *reply = get_reply("prefetch", REDIS_REPLY_ARRAY, ctx);
+    for (size_t j = 0; j < reply->elements; ++j) {
+      auto &value = prefetched[todo[i + j]];
+      switch (reply->element[j]->type) {
+      case REDIS_REPLY_NIL:
+        break;
+      case REDIS_REPLY_STRING:
+        // entries of older versions are just "XXX" and don't deserialize
+        value = CacheEntry::deserialize({ reply->element[j]->str,
+                                          reply->element[j]->len });
+        break;
+      default:
+        cerr << "Redis protocol error in prefetch, didn't expect reply type "
+             << redis_reply_string(reply->element[j]->type) << "\n";
+        exit(-1);
+      }
+    }
+    freeReplyObject(reply);
+  }
+}
+
+void RedisCache::flush() {
+  lock_guard lock(mutex);
+  sendStores();
+}
+
+// all the SETs are sent before reading any reply
+void RedisCache::sendStores() {
+  if (pending_stores.empty())
+    return;
+  connect();
+
+  for (auto &[key, data] : pending_stores)
+    append_command({ "SET", key.str(), data }, ctx);
+  for (size_t i = 0, e = pending_stores.size(); i != e; ++i)
+    freeReplyObject(get_reply("flush", REDIS_REPLY_STATUS, ctx));
+  pending_stores.clear();
+}
+#endif
@@ -3,17 +3,125 @@
 // Copyright (c) 2018-present The Alive2 Authors.
 // Distributed under the MIT license that can be found in the LICENSE file.
 
+#include "util/hash.h"
+#include <cstdint>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 struct redisContext;
 
+struct CacheEntry {
+  enum Verdict : uint8_t {
+    Seen,            // being verified by this process; never stored
+    Correct,
+    Unsound,
+    FailedToProve,   // e.g., because of approximations
+    TypeCheckFailed,
+    Timeout,
+    Error,           // the solver failed, e.g., it ran out of memory
+  };
+  Verdict verdict = Seen;
+  float time = 0;          // seconds spent verifying
+  unsigned timeout = 0;    // SMT query timeout it was given, in ms (0 = none)
+  std::string fingerprint; // the Alive2 version and options that verified it
+  std::string details;     // e.g., the counterexample
+
+  std::string serialize() const;
+  static std::optional<CacheEntry> deserialize(std::string_view data);
+};
+
 class Cache {
-  redisContext *ctx = nullptr;
+public:
+  virtual ~Cache() {}
+
+  // Content-addressed key of a transformation (given in a canonical textual
+  // form) together with the options that affect its verification
+  static Hash128 getKey(const std::string &transform);
+
+  // Version of Alive2 and the options above, to be stored in the entries
+  static std::string fingerprint();
+
+  virtual std::optional<CacheEntry> lookup(const Hash128 &key) = 0;
+  virtual void store(const Hash128 &key, const CacheEntry &entry) = 0;
+
+  // Fetch the entries of several keys at once, e.g., all the functions of a
+  // module, so that their lookups don't pay a round-trip each
+  virtual void prefetch(const std::vector<Hash128> &keys) {}
+
+  // Whether prefetch() saves enough to be worth putting off the verification
+  // of a module until all its functions are translated
+  virtual bool wantsPrefetch() const { return false; }
+
+  // Write back the entries stored so far, if store() buffers them
+  virtual void flush() {}
+};
+
+/*
+ * Cache in a local file shared by all the processes (and threads) that use
+ * it. The file is an append-only log of records, memory-mapped and indexed
+ * in memory by key; a later record for the same key supersedes earlier ones.
+ * Appends are serialized with a lock on the file, and a record torn by a
+ * crash is detected by its checksum and overwritten by the next append.
+ */
+class DiskCache final : public Cache {
+  std::string path;
+  int fd = -1;
+  const char *map = nullptr;
+  size_t map_size = 0;
+  // end of the last valid record indexed so far
+  size_t scanned = 0;
+  std::unordered_map<Hash128, size_t, Hash128::hasher> index;
+  std::mutex mutex;
+
+  bool error(const char *msg);
+  bool lockFile(bool lock);
+  bool update();
 
 public:
-  Cache(unsigned port, bool allow_version_mismatch);
+  DiskCache(const std::string &path, bool allow_version_mismatch);
+  ~DiskCache() override;
+
+  // $XDG_CACHE_HOME/alive2/results, or ~/.cache/alive2/results
+  static std::string defaultPath();
+
+  std::optional<CacheEntry> lookup(const Hash128 &key) override;
+  void store(const Hash128 &key, const CacheEntry &entry) override;
+};
+
 #ifndef NO_REDIS_SUPPORT
-  ~Cache();
-#endif
-  bool lookup(const std::string &s);
+/*
+ * Cache in a Redis server on localhost. Commands are pipelined: prefetch()
+ * gets all the given keys with MGETs in a single round-trip, and the SETs
+ * of store() are buffered until flush(). A forked child doesn't share the
+ * connection of its parent, but opens its own on first use.
+ */
+class RedisCache final : public Cache {
+  redisContext *ctx = nullptr;
+  unsigned port;
+  // process that opened ctx
+  int pid = -1;
+  std::unordered_map<Hash128, std::optional<CacheEntry>, Hash128::hasher>
+    prefetched;
+  // serialized entries
+  std::vector<std::pair<Hash128, std::string>> pending_stores;
+  std::mutex mutex;
+
+  void connect();
+  void sendStores();
+
+public:
+  RedisCache(unsigned port, bool allow_version_mismatch);
+  ~RedisCache() override;
+
+  std::optional<CacheEntry> lookup(const Hash128 &key) override;
+  void store(const Hash128 &key, const CacheEntry &entry) override;
+  void prefetch(const std::vector<Hash128> &keys) override;
+  bool wantsPrefetch() const override { return true; }
+  void flush() override;
 };
+#endif
@@ -0,0 +1,53 @@
+# smt/bitwuzla.cpp uses the term manager API of Bitwuzla 0.6
+if (NOT Bitwuzla_FIND_VERSION)
+  set(Bitwuzla_FIND_VERSION 0.6.0)
+endif()
+
+find_package(PkgConfig QUIET)
+if (PKG_CONFIG_FOUND)
+  pkg_check_modules(PC_BITWUZLA QUIET bitwuzla)
+endif()
+
+find_path(BITWUZLA_INCLUDE_DIR NAMES bitwuzla/c/bitwuzla.h
+          HINTS ${PC_BITWUZLA_INCLUDE_DIRS})
+find_library(BITWUZLA_LIBRARIES NAMES bitwuzla
+             HINTS ${PC_BITWUZLA_LIBRARY_DIRS})
+
+if (BITWUZLA_INCLUDE_DIR AND BITWUZLA_LIBRARIES)
+  # The installed bitwuzla.pc has the version; without it, check for the
+  # API instead
+  if (PC_BITWUZLA_VERSION)
+    set(Bitwuzla_VERSION ${PC_BITWUZLA_VERSION})
+    if (Bitwuzla_VERSION VERSION_LESS Bitwuzla_FIND_VERSION)
+      set(BITWUZLA_TOO_OLD ON)
+    endif()
+  else()
+    include(CheckCXXSourceCompiles)
+    set(CMAKE_REQUIRED_INCLUDES ${BITWUZLA_INCLUDE_DIR})
+    set(CMAKE_REQUIRED_LIBRARIES ${BITWUZLA_LIBRARIES})
+    check_cxx_source_compiles("
+      #include <bitwuzla/c/bitwuzla.h>
+      int main() {
+        BitwuzlaTermManager *tm = bitwuzla_term_manager_new();
+        bitwuzla_term_manager_delete(tm);
+      }" BITWUZLA_HAS_TERM_MANAGER)
+    unset(CMAKE_REQUIRED_INCLUDES)
+    unset(CMAKE_REQUIRED_LIBRARIES)
+    if (NOT BITWUZLA_HAS_TERM_MANAGER)
+      set(BITWUZLA_TOO_OLD ON)
+    endif()
+  endif()
+
+  if (BITWUZLA_TOO_OLD)
+    if (NOT Bitwuzla_VERSION)
+      set(Bitwuzla_VERSION "older, no term manager API")
+    endif()
+    message(WARNING "Bitwuzla ${Bitwuzla_FIND_VERSION} or later is required "
+                    "(installed: ${Bitwuzla_VERSION}); building without it")
+    set(BITWUZLA_LIBRARIES BITWUZLA_LIBRARIES-NOTFOUND)
+  endif()
+  unset(BITWUZLA_TOO_OLD)
+endif()
+
+message(STATUS "Bitwuzla: ${BITWUZLA_INCLUDE_DIR} ${BITWUZLA_LIBRARIES} "
+               "${Bitwuzla_VERSION}")
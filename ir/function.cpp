@@ -836,7 +836,7 @@ void Function::unroll(unsigned k) {
   }
 }
 
-void Function::print(ostream &os, bool print_header) const {
+void Function::printDecls(ostream &os) const {
   if (!fn_decls.empty()) {
     for (auto &decl : fn_decls) {
       os << "declare " << *decl.output << ' ' << decl.name << '(';
@@ -862,20 +862,26 @@ void Function::print(ostream &os, bool print_header) const {
       os << '\n';
     }
   }
+}
 
-  if (print_header) {
-    os << "define " << getType() << " @" << name << '(';
-    bool first = true;
-    for (auto &input : getInputs()) {
-      if (!first)
-        os << ", ";
-      os << input;
-      first = false;
-    }
-    if (isVarArgs())
-      os << (first ? "..." : ", ...");
-    os << ')' << attrs << " {\n";
+void Function::printHeader(ostream &os, string_view name) const {
+  os << "define " << getType() << " @" << name << '(';
+  bool first = true;
+  for (auto &input : getInputs()) {
+    if (!first)
+      os << ", ";
+    os << input;
+    first = false;
   }
+  if (isVarArgs())
+    os << (first ? "..." : ", ...");
+  os << ')' << attrs << " {\n";
+}
+
+void Function::print(ostream &os, bool print_header) const {
+  printDecls(os);
+  if (print_header)
+    printHeader(os, name);
 
   bool first = true;
   for (auto bb : BB_order) {
@@ -889,6 +895,58 @@ void Function::print(ostream &os, bool print_header) const {
     os << "}\n";
 }
 
+void Function::printCanonical(ostream &os) const {
+  // iterative DFS from the entry; successors are visited in the order of the
+  // terminator's operands, which doesn't depend on the order of the blocks
+  vector<const BasicBlock*> postorder;
+  unordered_set<const BasicBlock*> visited;
+  vector<pair<const BasicBlock*, vector<const BasicBlock*>>> stack;
+
+  auto push = [&](const BasicBlock &bb) {
+    if (!visited.emplace(&bb).second)
+      return;
+    vector<const BasicBlock*> succs;
+    for (auto &dst : bb.targets()) {
+      succs.emplace_back(&dst);
+    }
+    // successors are popped from the back, so the first one ends up first
+    // in reverse post-order
+    stack.emplace_back(&bb, std::move(succs));
+  };
+
+  push(getFirstBB());
+  while (!stack.empty()) {
+    auto &[bb, succs] = stack.back();
+    if (succs.empty()) {
+      postorder.emplace_back(bb);
+      stack.pop_back();
+    } else {
+      auto *dst = succs.back();
+      succs.pop_back();
+      push(*dst);
+    }
+  }
+
+  vector<const BasicBlock*> order(postorder.rbegin(), postorder.rend());
+  // unreachable blocks stay in their order
+  for (auto bb : BB_order) {
+    if (!visited.count(bb))
+      order.emplace_back(bb);
+  }
+
+  printDecls(os);
+  printHeader(os, "");
+  for (auto bb : order) {
+    os << bb->getName() << ":\n";
+    for (auto &i : bb->instrs()) {
+      os << "  ";
+      i.print(os);
+      os << '\n';
+    }
+  }
+  os << "}\n";
+}
+
 ostream& operator<<(ostream &os, const Function &f) {
   f.print(os);
   return os;
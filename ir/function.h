@@ -103,6 +103,9 @@ public:
 private:
   std::vector<FnDecl> fn_decls;
 
+  void printDecls(std::ostream &os) const;
+  void printHeader(std::ostream &os, std::string_view name) const;
+
 public:
   Function() = default;
   Function(Type &type, std::string &&name, unsigned bits_pointers = 64,
@@ -212,6 +215,10 @@ public:
   void unroll(unsigned k);
 
   void print(std::ostream &os, bool print_header = true) const;
+  // Prints the function without its name and with the blocks in reverse
+  // post-order, so that clones of a function print the same modulo the
+  // names of values and blocks (block labels are printed with the '%')
+  void printCanonical(std::ostream &os) const;
   friend std::ostream &operator<<(std::ostream &os, const Function &f);
   void writeDot(const char *filename_prefix) const;
 };
@@ -10,39 +10,39 @@ using namespace std;
 
 namespace IR {
 
-unsigned num_locals_src = 128;
-unsigned num_locals_tgt = 128;
-unsigned num_consts_src = 128;
-unsigned num_globals_src = 256;
-unsigned num_ptrinputs = 64;
-unsigned num_inaccessiblememonly_fns = 32;
-unsigned num_nonlocals = 256;
-unsigned num_nonlocals_src = 256;
-unsigned bits_poison_per_byte = 8;
-unsigned bits_for_ptrattrs = 8;
-unsigned bits_for_bid = 64;
-unsigned bits_for_offset = 64;
-unsigned bits_program_pointer = 64;
-unsigned bits_size_t = 64;
-unsigned bits_ptr_address = 64;
-unsigned bits_byte = 8;
-unsigned strlen_unroll_cnt = 8;
-unsigned memcmp_unroll_cnt = 8;
-bool little_endian = true;
-bool observes_addresses = true;
-bool has_alloca = true;
-bool has_fncall = true;
-bool has_write_fncall = true;
-bool has_nocapture = true;
-bool has_noread = true;
-bool has_nowrite = true;
-bool has_null_block = true;
-bool null_is_dereferenceable = false;
-bool does_int_mem_access = true;
-bool does_ptr_mem_access = true;
-bool does_ptr_store = true;
-unsigned heap_block_alignment = 8;
-bool has_indirect_fncalls = true;
+thread_local constinit unsigned num_locals_src = 128;
+thread_local constinit unsigned num_locals_tgt = 128;
+thread_local constinit unsigned num_consts_src = 128;
+thread_local constinit unsigned num_globals_src = 256;
+thread_local constinit unsigned num_ptrinputs = 64;
+thread_local constinit unsigned num_inaccessiblememonly_fns = 32;
+thread_local constinit unsigned num_nonlocals = 256;
+thread_local constinit unsigned num_nonlocals_src = 256;
+thread_local constinit unsigned bits_poison_per_byte = 8;
+thread_local constinit unsigned bits_for_ptrattrs = 8;
+thread_local constinit unsigned bits_for_bid = 64;
+thread_local constinit unsigned bits_for_offset = 64;
+thread_local constinit unsigned bits_program_pointer = 64;
+thread_local constinit unsigned bits_size_t = 64;
+thread_local constinit unsigned bits_ptr_address = 64;
+thread_local constinit unsigned bits_byte = 8;
+thread_local constinit unsigned strlen_unroll_cnt = 8;
+thread_local constinit unsigned memcmp_unroll_cnt = 8;
+thread_local constinit bool little_endian = true;
+thread_local constinit bool observes_addresses = true;
+thread_local constinit bool has_alloca = true;
+thread_local constinit bool has_fncall = true;
+thread_local constinit bool has_write_fncall = true;
+thread_local constinit bool has_nocapture = true;
+thread_local constinit bool has_noread = true;
+thread_local constinit bool has_nowrite = true;
+thread_local constinit bool has_null_block = true;
+thread_local constinit bool null_is_dereferenceable = false;
+thread_local constinit bool does_int_mem_access = true;
+thread_local constinit bool does_ptr_mem_access = true;
+thread_local constinit bool does_ptr_store = true;
+thread_local constinit unsigned heap_block_alignment = 8;
+thread_local constinit bool has_indirect_fncalls = true;
 
 
 bool isUndef(const expr &e) {
@@ -7,87 +7,90 @@ namespace smt { class expr; }
 
 namespace IR {
 
+// The following are computed for each transformation being verified, and
+// are per thread so that transformations can be verified concurrently.
+
 /// Upperbound of the number of local blocks
-extern unsigned num_locals_src, num_locals_tgt;
+extern thread_local constinit unsigned num_locals_src, num_locals_tgt;
 
 /// Number of constant global variables in src
-extern unsigned num_consts_src;
+extern thread_local constinit unsigned num_consts_src;
 
-extern unsigned num_globals_src;
+extern thread_local constinit unsigned num_globals_src;
 
-extern unsigned num_ptrinputs;
+extern thread_local constinit unsigned num_ptrinputs;
 
-extern unsigned num_inaccessiblememonly_fns;
+extern thread_local constinit unsigned num_inaccessiblememonly_fns;
 
 /// Number of non-constant globals introduced in tgt
-extern unsigned num_extra_nonconst_tgt;
+extern thread_local constinit unsigned num_extra_nonconst_tgt;
 
 // Upperbound of the number of nonlocal blocks
-extern unsigned num_nonlocals;
+extern thread_local constinit unsigned num_nonlocals;
 
 // Upperbound of the number of nonlocal blocks in src (<= num_nonlocals)
-extern unsigned num_nonlocals_src;
+extern thread_local constinit unsigned num_nonlocals_src;
 
-extern unsigned bits_poison_per_byte;
+extern thread_local constinit unsigned bits_poison_per_byte;
 
 /// Number of bits needed for attributes of pointers (e.g. nocapture).
-extern unsigned bits_for_ptrattrs;
+extern thread_local constinit unsigned bits_for_ptrattrs;
 
 /// Number of bits needed for encoding a memory block id
-extern unsigned bits_for_bid;
+extern thread_local constinit unsigned bits_for_bid;
 
 // Number of bits needed for encoding a pointer's offset
-extern unsigned bits_for_offset;
+extern thread_local constinit unsigned bits_for_offset;
 
 /// Size of a program pointer in bytes
-extern unsigned bits_program_pointer;
+extern thread_local constinit unsigned bits_program_pointer;
 
 /// sizeof(size_t)
-extern unsigned bits_size_t;
+extern thread_local constinit unsigned bits_size_t;
 
 /// >= bits_size_t && <= bits_program_pointer
-extern unsigned bits_ptr_address;
+extern thread_local constinit unsigned bits_ptr_address;
 
 /// Number of bits for a byte.
-extern unsigned bits_byte;
+extern thread_local constinit unsigned bits_byte;
 
-extern unsigned strlen_unroll_cnt;
-extern unsigned memcmp_unroll_cnt;
+extern thread_local constinit unsigned strlen_unroll_cnt;
+extern thread_local constinit unsigned memcmp_unroll_cnt;
 
-extern bool little_endian;
+extern thread_local constinit bool little_endian;
 
 /// Whether pointer addresses are observed
-extern bool observes_addresses;
+extern thread_local constinit bool observes_addresses;
 
 /// Whether there is an alloca
-extern bool has_alloca;
+extern thread_local constinit bool has_alloca;
 
-extern bool has_fncall;
+extern thread_local constinit bool has_fncall;
 
 // has a function call that writes to global memory (not-inaccessible only)
-extern bool has_write_fncall;
+extern thread_local constinit bool has_write_fncall;
 
 /// Whether any function argument (not function call arg) has the attribute
-extern bool has_nocapture;
-extern bool has_noread;
-extern bool has_nowrite;
+extern thread_local constinit bool has_nocapture;
+extern thread_local constinit bool has_noread;
+extern thread_local constinit bool has_nowrite;
 
 /// Whether there null pointers appear in the program
-extern bool has_null_pointer;
+extern thread_local constinit bool has_null_pointer;
 
 /// Whether the null block should be allocated
-extern bool has_null_block;
+extern thread_local constinit bool has_null_block;
 
-extern bool null_is_dereferenceable;
+extern thread_local constinit bool null_is_dereferenceable;
 
 /// Whether the programs do memory accesses that load/store int/ptrs
-extern bool does_int_mem_access;
-extern bool does_ptr_mem_access;
-extern bool does_ptr_store;
+extern thread_local constinit bool does_int_mem_access;
+extern thread_local constinit bool does_ptr_mem_access;
+extern thread_local constinit bool does_ptr_store;
 
-extern unsigned heap_block_alignment;
+extern thread_local constinit unsigned heap_block_alignment;
 
-extern bool has_indirect_fncalls;
+extern thread_local constinit bool has_indirect_fncalls;
 
 bool isUndef(const smt::expr &e);
 
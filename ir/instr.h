@@ -1209,32 +1209,38 @@ public:
 
 class X86IntrinBinOp final : public Instr {
 public:
-  static constexpr unsigned numOfX86Intrinsics = 135;
+  static constexpr unsigned numOfX86Intrinsics = 0
+#define PROCESS(NAME,KIND,A,B,C,D,E,F) + 1
+#include "ir/intrinsics_binop.h"
+#undef PROCESS
+  ;
   enum Op {
-#define PROCESS(NAME,A,B,C,D,E,F) NAME,
-#include "intrinsics_binop.h"
+#define PROCESS(NAME,KIND,A,B,C,D,E,F) NAME,
+#include "ir/intrinsics_binop.h"
 #undef PROCESS
   };
 
   // the shape of a vector is stored as <# of lanes, element bits>
+  // The tables are generated from ir/x86_intrinsics.spec; KIND names the
+  // semantics kernel in x86_intrinsics.cpp
   static constexpr std::array<std::pair<unsigned, unsigned>, numOfX86Intrinsics> shape_op0 = {
-#define PROCESS(NAME,A,B,C,D,E,F) std::make_pair(C, D),
-#include "intrinsics_binop.h"
+#define PROCESS(NAME,KIND,A,B,C,D,E,F) std::make_pair(C, D),
+#include "ir/intrinsics_binop.h"
 #undef PROCESS
   };
   static constexpr std::array<std::pair<unsigned, unsigned>, numOfX86Intrinsics> shape_op1 = {
-#define PROCESS(NAME,A,B,C,D,E,F) std::make_pair(E, F),
-#include "intrinsics_binop.h"
+#define PROCESS(NAME,KIND,A,B,C,D,E,F) std::make_pair(E, F),
+#include "ir/intrinsics_binop.h"
 #undef PROCESS
   };
   static constexpr std::array<std::pair<unsigned, unsigned>, numOfX86Intrinsics> shape_ret = {
-#define PROCESS(NAME,A,B,C,D,E,F) std::make_pair(A, B),
-#include "intrinsics_binop.h"
+#define PROCESS(NAME,KIND,A,B,C,D,E,F) std::make_pair(A, B),
+#include "ir/intrinsics_binop.h"
 #undef PROCESS
   };
   static constexpr std::array<unsigned, numOfX86Intrinsics> ret_width = {
-#define PROCESS(NAME,A,B,C,D,E,F) A * B,
-#include "intrinsics_binop.h"
+#define PROCESS(NAME,KIND,A,B,C,D,E,F) A * B,
+#include "ir/intrinsics_binop.h"
 #undef PROCESS
   };
 
@@ -1246,6 +1252,7 @@ public:
   static unsigned getRetWidth(Op op) { return ret_width[op]; }
   X86IntrinBinOp(Type &type, std::string &&name, Value &a, Value &b, Op op)
     : Instr(type, std::move(name)), a(&a), b(&b), op(op) {}
+  Op getOp() const { return op; }
   std::vector<Value*> operands() const override;
   bool propagatesPoison() const override;
   bool hasSideEffects() const override;
@@ -1260,37 +1267,41 @@ public:
 
 class X86IntrinTerOp final : public Instr {
 public:
-  static constexpr unsigned numOfX86Intrinsics = 1;
+  static constexpr unsigned numOfX86Intrinsics = 0
+#define PROCESS(NAME,KIND,A,B,C,D,E,F,G,H) + 1
+#include "ir/intrinsics_terop.h"
+#undef PROCESS
+  ;
   enum Op {
-#define PROCESS(NAME,A,B,C,D,E,F,G,H) NAME,
-#include "intrinsics_terop.h"
+#define PROCESS(NAME,KIND,A,B,C,D,E,F,G,H) NAME,
+#include "ir/intrinsics_terop.h"
 #undef PROCESS
   };
 
   // the shape of a vector is stored as <# of lanes, element bits>
   static constexpr std::array<std::pair<unsigned, unsigned>, numOfX86Intrinsics> shape_op0 = {
-#define PROCESS(NAME,A,B,C,D,E,F,G,H) std::make_pair(C, D),
-#include "intrinsics_terop.h"
+#define PROCESS(NAME,KIND,A,B,C,D,E,F,G,H) std::make_pair(C, D),
+#include "ir/intrinsics_terop.h"
 #undef PROCESS
   };
   static constexpr std::array<std::pair<unsigned, unsigned>, numOfX86Intrinsics> shape_op1 = {
-#define PROCESS(NAME,A,B,C,D,E,F,G,H) std::make_pair(E, F),
-#include "intrinsics_terop.h"
+#define PROCESS(NAME,KIND,A,B,C,D,E,F,G,H) std::make_pair(E, F),
+#include "ir/intrinsics_terop.h"
 #undef PROCESS
   };
   static constexpr std::array<std::pair<unsigned, unsigned>, numOfX86Intrinsics> shape_op2 = {
-#define PROCESS(NAME,A,B,C,D,E,F,G,H) std::make_pair(G, H),
-#include "intrinsics_terop.h"
+#define PROCESS(NAME,KIND,A,B,C,D,E,F,G,H) std::make_pair(G, H),
+#include "ir/intrinsics_terop.h"
 #undef PROCESS
   };
   static constexpr std::array<std::pair<unsigned, unsigned>, numOfX86Intrinsics> shape_ret = {
-#define PROCESS(NAME,A,B,C,D,E,F,G,H) std::make_pair(A, B),
-#include "intrinsics_terop.h"
+#define PROCESS(NAME,KIND,A,B,C,D,E,F,G,H) std::make_pair(A, B),
+#include "ir/intrinsics_terop.h"
 #undef PROCESS
   };
   static constexpr std::array<unsigned, numOfX86Intrinsics> ret_width = {
-#define PROCESS(NAME,A,B,C,D,E,F,G,H) A * B,
-#include "intrinsics_terop.h"
+#define PROCESS(NAME,KIND,A,B,C,D,E,F,G,H) A * B,
+#include "ir/intrinsics_terop.h"
 #undef PROCESS
   };
 
@@ -1303,6 +1314,74 @@ public:
   X86IntrinTerOp(Type &type, std::string &&name,
     Value &a, Value &b, Value &c, Op op)
     : Instr(type, std::move(name)), a(&a), b(&b), c(&c), op(op) {}
+  Op getOp() const { return op; }
+  std::vector<Value*> operands() const override;
+  bool propagatesPoison() const override;
+  bool hasSideEffects() const override;
+  void rauw(const Value &what, Value &with) override;
+  static std::string getOpName(Op op);
+  void print(std::ostream &os) const override;
+  StateValue toSMT(State &s) const override;
+  smt::expr getTypeConstraints(const Function &f) const override;
+  std::unique_ptr<Instr>
+    dup(Function &f, const std::string &suffix) const override;
+};
+
+class X86IntrinQuadOp final : public Instr {
+public:
+  static constexpr unsigned numOfX86Intrinsics = 0
+#define PROCESS(NAME,KIND,A,B,C,D,E,F,G,H,I,J) + 1
+#include "ir/intrinsics_quadop.h"
+#undef PROCESS
+  ;
+  enum Op {
+#define PROCESS(NAME,KIND,A,B,C,D,E,F,G,H,I,J) NAME,
+#include "ir/intrinsics_quadop.h"
+#undef PROCESS
+  };
+
+  // the shape of a vector is stored as <# of lanes, element bits>
+  static constexpr std::array<std::pair<unsigned, unsigned>, numOfX86Intrinsics> shape_op0 = {
+#define PROCESS(NAME,KIND,A,B,C,D,E,F,G,H,I,J) std::make_pair(C, D),
+#include "ir/intrinsics_quadop.h"
+#undef PROCESS
+  };
+  static constexpr std::array<std::pair<unsigned, unsigned>, numOfX86Intrinsics> shape_op1 = {
+#define PROCESS(NAME,KIND,A,B,C,D,E,F,G,H,I,J) std::make_pair(E, F),
+#include "ir/intrinsics_quadop.h"
+#undef PROCESS
+  };
+  static constexpr std::array<std::pair<unsigned, unsigned>, numOfX86Intrinsics> shape_op2 = {
+#define PROCESS(NAME,KIND,A,B,C,D,E,F,G,H,I,J) std::make_pair(G, H),
+#include "ir/intrinsics_quadop.h"
+#undef PROCESS
+  };
+  static constexpr std::array<std::pair<unsigned, unsigned>, numOfX86Intrinsics> shape_op3 = {
+#define PROCESS(NAME,KIND,A,B,C,D,E,F,G,H,I,J) std::make_pair(I, J),
+#include "ir/intrinsics_quadop.h"
+#undef PROCESS
+  };
+  static constexpr std::array<std::pair<unsigned, unsigned>, numOfX86Intrinsics> shape_ret = {
+#define PROCESS(NAME,KIND,A,B,C,D,E,F,G,H,I,J) std::make_pair(A, B),
+#include "ir/intrinsics_quadop.h"
+#undef PROCESS
+  };
+  static constexpr std::array<unsigned, numOfX86Intrinsics> ret_width = {
+#define PROCESS(NAME,KIND,A,B,C,D,E,F,G,H,I,J) A * B,
+#include "ir/intrinsics_quadop.h"
+#undef PROCESS
+  };
+
+private:
+  Value *a, *b, *c, *d;
+  Op op;
+
+public:
+  static unsigned getRetWidth(Op op) { return ret_width[op]; }
+  X86IntrinQuadOp(Type &type, std::string &&name,
+    Value &a, Value &b, Value &c, Value &d, Op op)
+    : Instr(type, std::move(name)), a(&a), b(&b), c(&c), d(&d), op(op) {}
+  Op getOp() const { return op; }
   std::vector<Value*> operands() const override;
   bool propagatesPoison() const override;
   bool hasSideEffects() const override;
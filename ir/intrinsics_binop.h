@@ -1,135 +0,0 @@
-PROCESS(x86_sse2_pavg_w,8,16,8,16,8,16)
-PROCESS(x86_sse2_pavg_b,16,8,16,8,16,8)
-PROCESS(x86_avx2_pavg_w,16,16,16,16,16,16)
-PROCESS(x86_avx2_pavg_b,32,8,32,8,32,8)
-PROCESS(x86_avx512_pavg_w_512,32,16,32,16,32,16)
-PROCESS(x86_avx512_pavg_b_512,64,8,64,8,64,8)
-PROCESS(x86_avx2_pshuf_b,32,8,32,8,32,8)
-PROCESS(x86_ssse3_pshuf_b_128,16,8,16,8,16,8)
-PROCESS(x86_avx512_pshuf_b_512,64,8,64,8,64,8)
-PROCESS(x86_sse2_psrl_w,8,16,8,16,8,16)
-PROCESS(x86_sse2_psrl_d,4,32,4,32,4,32)
-PROCESS(x86_sse2_psrl_q,2,64,2,64,2,64)
-PROCESS(x86_avx2_psrl_w,16,16,16,16,8,16)
-PROCESS(x86_avx2_psrl_d,8,32,8,32,4,32)
-PROCESS(x86_avx2_psrl_q,4,64,4,64,2,64)
-PROCESS(x86_avx512_psrl_w_512,32,16,32,16,8,16)
-PROCESS(x86_avx512_psrl_d_512,16,32,16,32,4,32)
-PROCESS(x86_avx512_psrl_q_512,8,64,8,64,2,64)
-PROCESS(x86_sse2_psrli_w,8,16,8,16,1,32)
-PROCESS(x86_sse2_psrli_d,4,32,4,32,1,32)
-PROCESS(x86_sse2_psrli_q,2,64,2,64,1,32)
-PROCESS(x86_avx2_psrli_w,16,16,16,16,1,32)
-PROCESS(x86_avx2_psrli_d,8,32,8,32,1,32)
-PROCESS(x86_avx2_psrli_q,4,64,4,64,1,32)
-PROCESS(x86_avx512_psrli_w_512,32,16,32,16,1,32)
-PROCESS(x86_avx512_psrli_d_512,16,32,16,32,1,32)
-PROCESS(x86_avx512_psrli_q_512,8,64,8,64,1,32)
-PROCESS(x86_avx2_psrlv_d,4,32,4,32,4,32)
-PROCESS(x86_avx2_psrlv_d_256,8,32,8,32,8,32)
-PROCESS(x86_avx2_psrlv_q,2,64,2,64,2,64)
-PROCESS(x86_avx2_psrlv_q_256,4,64,4,64,4,64)
-PROCESS(x86_avx512_psrlv_d_512,16,32,16,32,16,32)
-PROCESS(x86_avx512_psrlv_q_512,8,64,8,64,8,64)
-PROCESS(x86_avx512_psrlv_w_128,8,16,8,16,8,16)
-PROCESS(x86_avx512_psrlv_w_256,16,16,16,16,16,16)
-PROCESS(x86_avx512_psrlv_w_512,32,16,32,16,32,16)
-PROCESS(x86_sse2_psra_w,8,16,8,16,8,16)
-PROCESS(x86_sse2_psra_d,4,32,4,32,4,32)
-PROCESS(x86_avx2_psra_w,16,16,16,16,8,16)
-PROCESS(x86_avx2_psra_d,8,32,8,32,4,32)
-PROCESS(x86_avx512_psra_q_128,2,64,2,64,2,64)
-PROCESS(x86_avx512_psra_q_256,4,64,4,64,2,64)
-PROCESS(x86_avx512_psra_w_512,32,16,32,16,8,16)
-PROCESS(x86_avx512_psra_d_512,16,32,16,32,4,32)
-PROCESS(x86_avx512_psra_q_512,8,64,8,64,2,64)
-PROCESS(x86_sse2_psrai_w,8,16,8,16,1,32)
-PROCESS(x86_sse2_psrai_d,4,32,4,32,1,32)
-PROCESS(x86_avx2_psrai_w,16,16,16,16,1,32)
-PROCESS(x86_avx2_psrai_d,8,32,8,32,1,32)
-PROCESS(x86_avx512_psrai_w_512,32,16,32,16,1,32)
-PROCESS(x86_avx512_psrai_d_512,16,32,16,32,1,32)
-PROCESS(x86_avx512_psrai_q_128,2,64,2,64,1,32)
-PROCESS(x86_avx512_psrai_q_256,4,64,4,64,1,32)
-PROCESS(x86_avx512_psrai_q_512,8,64,8,64,1,32)
-PROCESS(x86_avx2_psrav_d,4,32,4,32,4,32)
-PROCESS(x86_avx2_psrav_d_256,8,32,8,32,8,32)
-PROCESS(x86_avx512_psrav_d_512,16,32,16,32,16,32)
-PROCESS(x86_avx512_psrav_q_128,2,64,2,64,2,64)
-PROCESS(x86_avx512_psrav_q_256,4,64,4,64,4,64)
-PROCESS(x86_avx512_psrav_q_512,8,64,8,64,8,64)
-PROCESS(x86_avx512_psrav_w_128,8,16,8,16,8,16)
-PROCESS(x86_avx512_psrav_w_256,16,16,16,16,16,16)
-PROCESS(x86_avx512_psrav_w_512,32,16,32,16,32,16)
-PROCESS(x86_sse2_psll_w,8,16,8,16,8,16)
-PROCESS(x86_sse2_psll_d,4,32,4,32,4,32)
-PROCESS(x86_sse2_psll_q,2,64,2,64,2,64)
-PROCESS(x86_avx2_psll_w,16,16,16,16,8,16)
-PROCESS(x86_avx2_psll_d,8,32,8,32,4,32)
-PROCESS(x86_avx2_psll_q,4,64,4,64,2,64)
-PROCESS(x86_avx512_psll_w_512,32,16,32,16,8,16)
-PROCESS(x86_avx512_psll_d_512,16,32,16,32,4,32)
-PROCESS(x86_avx512_psll_q_512,8,64,8,64,2,64)
-PROCESS(x86_sse2_pslli_w,8,16,8,16,1,32)
-PROCESS(x86_sse2_pslli_d,4,32,4,32,1,32)
-PROCESS(x86_sse2_pslli_q,2,64,2,64,1,32)
-PROCESS(x86_avx2_pslli_w,16,16,16,16,1,32)
-PROCESS(x86_avx2_pslli_d,8,32,8,32,1,32)
-PROCESS(x86_avx2_pslli_q,4,64,4,64,1,32)
-PROCESS(x86_avx512_pslli_w_512,32,16,32,16,1,32)
-PROCESS(x86_avx512_pslli_d_512,16,32,16,32,1,32)
-PROCESS(x86_avx512_pslli_q_512,8,64,8,64,1,32)
-PROCESS(x86_avx2_psllv_d,4,32,4,32,4,32)
-PROCESS(x86_avx2_psllv_d_256,8,32,8,32,8,32)
-PROCESS(x86_avx2_psllv_q,2,64,2,64,2,64)
-PROCESS(x86_avx2_psllv_q_256,4,64,4,64,4,64)
-PROCESS(x86_avx512_psllv_d_512,16,32,16,32,16,32)
-PROCESS(x86_avx512_psllv_q_512,8,64,8,64,8,64)
-PROCESS(x86_avx512_psllv_w_128,8,16,8,16,8,16)
-PROCESS(x86_avx512_psllv_w_256,16,16,16,16,16,16)
-PROCESS(x86_avx512_psllv_w_512,32,16,32,16,32,16)
-PROCESS(x86_ssse3_psign_b_128,16,8,16,8,16,8)
-PROCESS(x86_ssse3_psign_w_128,8,16,8,16,8,16)
-PROCESS(x86_ssse3_psign_d_128,4,32,4,32,4,32)
-PROCESS(x86_avx2_psign_b,32,8,32,8,32,8)
-PROCESS(x86_avx2_psign_w,16,16,16,16,16,16)
-PROCESS(x86_avx2_psign_d,8,32,8,32,8,32)
-PROCESS(x86_ssse3_phadd_w_128,8,16,8,16,8,16)
-PROCESS(x86_ssse3_phadd_d_128,4,32,4,32,4,32)
-PROCESS(x86_ssse3_phadd_sw_128,8,16,8,16,8,16)
-PROCESS(x86_avx2_phadd_w,16,16,16,16,16,16)
-PROCESS(x86_avx2_phadd_d,8,32,8,32,8,32)
-PROCESS(x86_avx2_phadd_sw,16,16,16,16,16,16)
-PROCESS(x86_ssse3_phsub_w_128,8,16,8,16,8,16)
-PROCESS(x86_ssse3_phsub_d_128,4,32,4,32,4,32)
-PROCESS(x86_ssse3_phsub_sw_128,8,16,8,16,8,16)
-PROCESS(x86_avx2_phsub_w,16,16,16,16,16,16)
-PROCESS(x86_avx2_phsub_d,8,32,8,32,8,32)
-PROCESS(x86_avx2_phsub_sw,16,16,16,16,16,16)
-PROCESS(x86_sse2_pmulh_w,8,16,8,16,8,16)
-PROCESS(x86_avx2_pmulh_w,16,16,16,16,16,16)
-PROCESS(x86_avx512_pmulh_w_512,32,16,32,16,32,16)
-PROCESS(x86_sse2_pmulhu_w,8,16,8,16,8,16)
-PROCESS(x86_avx2_pmulhu_w,16,16,16,16,16,16)
-PROCESS(x86_avx512_pmulhu_w_512,32,16,32,16,32,16)
-PROCESS(x86_sse2_pmadd_wd,4,32,8,16,8,16)
-PROCESS(x86_avx2_pmadd_wd,8,32,16,16,16,16)
-PROCESS(x86_avx512_pmaddw_d_512,16,32,32,16,32,16)
-PROCESS(x86_ssse3_pmadd_ub_sw_128,8,16,16,8,16,8)
-PROCESS(x86_avx2_pmadd_ub_sw,16,16,32,8,32,8)
-PROCESS(x86_avx512_pmaddubs_w_512,32,16,64,8,64,8)
-PROCESS(x86_sse2_packsswb_128,16,8,8,16,8,16)
-PROCESS(x86_avx2_packsswb,32,8,16,16,16,16)
-PROCESS(x86_avx512_packsswb_512,64,8,32,16,32,16)
-PROCESS(x86_sse2_packuswb_128,16,8,8,16,8,16)
-PROCESS(x86_avx2_packuswb,32,8,16,16,16,16)
-PROCESS(x86_avx512_packuswb_512,64,8,32,16,32,16)
-PROCESS(x86_sse2_packssdw_128,8,16,4,32,4,32)
-PROCESS(x86_avx2_packssdw,16,16,8,32,8,32)
-PROCESS(x86_avx512_packssdw_512,32,16,16,32,16,32)
-PROCESS(x86_sse41_packusdw,8,16,4,32,4,32)
-PROCESS(x86_avx2_packusdw,16,16,8,32,8,32)
-PROCESS(x86_avx512_packusdw_512,32,16,16,32,16,32)
-PROCESS(x86_sse2_psad_bw,2,64,16,8,16,8)
-PROCESS(x86_avx2_psad_bw,4,64,32,8,32,8)
-PROCESS(x86_avx512_psad_bw_512,8,64,64,8,64,8)
\ No newline at end of file
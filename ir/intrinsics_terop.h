@@ -1 +0,0 @@
-PROCESS(x86_avx2_pblendvb,32,8,32,8,32,8,32,8)
\ No newline at end of file
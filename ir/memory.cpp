@@ -10,8 +10,10 @@
 #include "util/compiler.h"
 #include "util/config.h"
 #include <array>
+#include <atomic>
 #include <numeric>
 #include <string>
+#include <type_traits>
 
 using namespace IR;
 using namespace smt;
@@ -103,10 +105,10 @@ static bool always_nowrite(unsigned bid, bool src_only = false,
 }
 
 
-static unsigned next_local_bid;
-static unsigned next_const_bid;
-static unsigned next_global_bid;
-static unsigned next_ptr_input;
+static thread_local unsigned next_local_bid;
+static thread_local unsigned next_const_bid;
+static thread_local unsigned next_global_bid;
+static thread_local unsigned next_ptr_input;
 
 static bool byte_has_ptr_bit() {
   return true;
@@ -562,11 +564,11 @@ static StateValue bytesToValue(const Memory &m, const vector<Byte> &bytes,
 namespace IR {
 
 Memory::AliasSet::AliasSet(const Memory &m)
-  : local(m.numLocals(), false), non_local(m.numNonlocals(), false) {}
+  : local(m.numLocals()), non_local(m.numNonlocals()) {}
 
 Memory::AliasSet::AliasSet(const Memory &m1, const Memory &m2)
-  : local(max(m1.numLocals(), m2.numLocals()), false),
-    non_local(max(m1.numNonlocals(), m2.numNonlocals()), false) {}
+  : local(max(m1.numLocals(), m2.numLocals())),
+    non_local(max(m1.numNonlocals(), m2.numNonlocals())) {}
 
 size_t Memory::AliasSet::size(bool islocal) const {
   return (islocal ? local : non_local).size();
@@ -574,16 +576,8 @@ size_t Memory::AliasSet::size(bool islocal) const {
 
 int Memory::AliasSet::isFullUpToAlias(bool islocal) const {
   auto &v = islocal ? local : non_local;
-  unsigned i = 0;
-  for (unsigned e = v.size(); i != e; ++i) {
-    if (!v[i])
-      break;
-  }
-  for (unsigned i2 = i, e = v.size(); i2 != e; ++i2) {
-    if (v[i])
-      return -1;
-  }
-  return i - 1;
+  unsigned i = v.countTrailingOnes();
+  return v.count() == i ? (int)i - 1 : -1;
 }
 
 expr Memory::AliasSet::mayAlias(bool islocal, const expr &bid) const {
@@ -591,62 +585,71 @@ expr Memory::AliasSet::mayAlias(bool islocal, const expr &bid) const {
   if (upto >= 0)
     return bid.ule(upto);
 
+  auto &v = islocal ? local : non_local;
   expr ret(false);
-  for (unsigned i = 0, e = size(islocal); i < e; ++i) {
-    if (mayAlias(islocal, i))
-      ret |= bid == i;
+  for (unsigned i = v.findNext(0), e = v.size(); i < e; i = v.findNext(i+1)) {
+    ret |= bid == i;
   }
   return ret;
 }
 
 bool Memory::AliasSet::mayAlias(bool islocal, unsigned bid) const {
-  return (islocal ? local : non_local)[bid];
+  return (islocal ? local : non_local).test(bid);
 }
 
 unsigned Memory::AliasSet::numMayAlias(bool islocal) const {
-  auto &v = islocal ? local : non_local;
-  return count(v.begin(), v.end(), true);
+  return (islocal ? local : non_local).count();
 }
 
 void Memory::AliasSet::setMayAlias(bool islocal, unsigned bid) {
-  (islocal ? local : non_local)[bid] = true;
+  (islocal ? local : non_local).set(bid);
 }
 
 void Memory::AliasSet::setMayAliasUpTo(bool local, unsigned limit) {
-  for (unsigned i = 0; i <= limit; ++i) {
-    setMayAlias(local, i);
-  }
+  (local ? this->local : non_local).setUpTo(limit);
 }
 
 void Memory::AliasSet::setNoAlias(bool islocal, unsigned bid) {
-  (islocal ? local : non_local)[bid] = false;
+  (islocal ? local : non_local).reset(bid);
 }
 
 void Memory::AliasSet::intersectWith(const AliasSet &other) {
-  auto intersect = [](auto &a, const auto &b) {
-    auto I2 = b.begin(), E2 = b.end();
-    for (auto I = a.begin(), E = a.end(); I != E && I2 != E2; ++I, ++I2) {
-      *I = *I && *I2;
-    }
-  };
-  intersect(local, other.local);
-  intersect(non_local, other.non_local);
+  local.intersectWith(other.local);
+  non_local.intersectWith(other.non_local);
 }
 
 void Memory::AliasSet::unionWith(const AliasSet &other) {
-  auto unionfn = [](auto &a, const auto &b) {
-    auto I2 = b.begin(), E2 = b.end();
-    for (auto I = a.begin(), E = a.end(); I != E && I2 != E2; ++I, ++I2) {
-      *I = *I || *I2;
-    }
-  };
-  unionfn(local, other.local);
-  unionfn(non_local, other.non_local);
+  local.unionWith(other.local);
+  non_local.unionWith(other.non_local);
+}
+
+vector<const Memory::AliasMap::value_type*> Memory::AliasMap::sorted() const {
+  vector<const value_type*> ret;
+  ret.reserve(size());
+  for (auto &p : *this) {
+    ret.emplace_back(&p);
+  }
+  sort(ret.begin(), ret.end(),
+       [](auto *a, auto *b) { return a->first < b->first; });
+  return ret;
+}
+
+weak_ordering Memory::AliasMap::operator<=>(const AliasMap &rhs) const {
+  if (auto cmp = size() <=> rhs.size(); is_neq(cmp))
+    return cmp;
+  auto a = sorted(), b = rhs.sorted();
+  for (unsigned i = 0, e = a.size(); i != e; ++i) {
+    if (auto cmp = a[i]->first <=> b[i]->first; is_neq(cmp))
+      return cmp;
+    if (auto cmp = a[i]->second <=> b[i]->second; is_neq(cmp))
+      return cmp;
+  }
+  return weak_ordering::equivalent;
 }
 
 static const array<uint64_t, 5> alias_buckets_vals = { 1, 2, 3, 5, 10 };
-static array<uint64_t, 6> alias_buckets_hits = { 0 };
-static uint64_t only_local = 0, only_nonlocal = 0;
+static array<atomic<uint64_t>, 6> alias_buckets_hits = {};
+static atomic<uint64_t> only_local = 0, only_nonlocal = 0;
 
 void Memory::AliasSet::computeAccessStats() const {
   auto nlocal = numMayAlias(true);
@@ -698,8 +701,8 @@ void Memory::AliasSet::printStats(ostream &os) {
 void Memory::AliasSet::print(ostream &os) const {
   auto print = [&](const char *str, const auto &v) {
     os << str;
-    for (auto bit : v) {
-      os << bit;
+    for (unsigned i = 0, e = v.size(); i != e; ++i) {
+      os << v.test(i);
     }
   };
 
@@ -725,6 +728,49 @@ weak_ordering Memory::MemBlock::operator<=>(const MemBlock &rhs) const {
   return weak_ordering::equivalent;
 }
 
+expr Memory::MemBlock::load(const expr &offset) const {
+  uint64_t off;
+  if (!writes_val.isValid() || !offset.isUInt(off) || !val.eq(writes_val))
+    return val.load(offset);
+
+  auto I = writes.find(off);
+  return I != writes.end() ? I->second : writes_base.load(offset);
+}
+
+void Memory::MemBlock::storeConst(const vector<pair<uint64_t, expr>> &data,
+                                  expr *base) {
+  if (base) {
+    writes.clear();
+    writes_base = std::move(*base);
+  } else if (!writes_val.isValid() || !val.eq(writes_val)) {
+    writes.clear();
+    writes_base = val;
+  }
+
+  // Stores past the last offset extend the chain; otherwise rebuild it so
+  // that each offset is stored once
+  bool append = !base && val.eq(writes_val);
+  uint64_t last = writes.empty() ? 0 : writes.rbegin()->first;
+  for (auto &[off, byte] : data) {
+    append &= writes.empty() || off > last;
+    last = max(last, off);
+    writes.insert_or_assign(off, byte);
+  }
+
+  auto off_sort = expr::mkUInt(0, Pointer::bitsShortOffset());
+  if (append) {
+    for (auto &[off, byte] : data) {
+      val = val.store(expr::mkUInt(off, off_sort), byte);
+    }
+  } else {
+    val = writes_base;
+    for (auto &[off, byte] : writes) {
+      val = val.store(expr::mkUInt(off, off_sort), byte);
+    }
+  }
+  writes_val = val;
+}
+
 
 static set<Pointer> all_leaf_ptrs(const Memory &m, const expr &ptr) {
   set<Pointer> ptrs;
@@ -862,8 +908,8 @@ Memory::AliasSet Memory::computeAliasing(const Pointer &ptr, unsigned bytes,
 
 end:
     // intersect computed aliasing with known aliasing
-    auto I = ptr_alias.find(p.getBid());
-    if (I != ptr_alias.end())
+    auto I = ptr_alias->find(p.getBid());
+    if (I != ptr_alias->end())
       this_alias.intersectWith(I->second);
     aliasing.unionWith(this_alias);
   }
@@ -871,8 +917,8 @@ end:
   // intersect computed aliasing with known aliasing
   // We can't store the result since our cache is per Bid expression only
   // and doesn't take byte size, etc into account.
-  auto I = ptr_alias.find(ptr.getBid());
-  if (I != ptr_alias.end())
+  auto I = ptr_alias->find(ptr.getBid());
+  if (I != ptr_alias->end())
     aliasing.intersectWith(I->second);
 
   aliasing.computeAccessStats();
@@ -895,10 +941,18 @@ void Memory::access(const Pointer &ptr, unsigned bytes, uint64_t align,
   auto sz_local = aliasing.size(true);
   auto sz_nonlocal = aliasing.size(false);
 
+  // only copy the blocks that are modified
+  auto block = [](MemBlocks &blocks, unsigned bid) -> decltype(auto) {
+    if constexpr (is_invocable_v<Fn&, const MemBlock&, unsigned, bool, expr&&>)
+      return blocks[bid];
+    else
+      return blocks.write(bid);
+  };
+
   for (unsigned i = 0; i < sz_local; ++i) {
     if (aliasing.mayAlias(true, i)) {
       auto n = expr::mkUInt(i, Pointer::bitsShortBid());
-      fn(local_block_val[i], i, true,
+      fn(block(local_block_val, i), i, true,
          is_singleton ? true
                       : (has_local == 1
                            ? is_local
@@ -913,7 +967,8 @@ void Memory::access(const Pointer &ptr, unsigned bytes, uint64_t align,
       // If aliasing info says it can, either imprecise analysis or incorrect
       // block id encoding is happening.
       assert(!is_fncall_mem(i));
-      fn(non_local_block_val[i], i, false,
+      markAccessed(i);
+      fn(block(non_local_block_val, i), i, false,
          is_singleton ? true : (has_nonlocal == 1 ? !is_local : bid == i));
     }
   }
@@ -938,7 +993,7 @@ vector<Byte> Memory::load(const Pointer &ptr, unsigned bytes, set<expr> &undef,
       unsigned idx = left2right ? i : (loaded_bytes - i - 1);
       expr off = offset + expr::mkUInt(idx, off_bits);
       loaded[i].add(is_poison ? Byte::mkPoisonByte(*this)()
-                              : blk.val.load(off), cond);
+                              : blk.load(off), cond);
       if (!is_poison)
         undef.insert(blk.undef.begin(), blk.undef.end());
     }
@@ -996,6 +1051,11 @@ void Memory::store(const Pointer &ptr,
   auto stored_ty = data_type(data, false);
   auto stored_ty_full = data_type(data, true);
 
+  // Stores to a known offset of a single block are kept per offset, so that
+  // later loads don't need to go through the whole store chain
+  uint64_t const_offset;
+  bool is_const_offset = offset.isUInt(const_offset);
+
   auto fn = [&](MemBlock &blk, unsigned bid, bool local, expr &&cond) {
     auto mem = blk.val;
 
@@ -1017,6 +1077,21 @@ void Memory::store(const Pointer &ptr,
       blk.type |= stored_ty;
     }
 
+    if (is_const_offset && cond.isTrue()) {
+      uint64_t mask = off_bits >= 64 ? UINT64_MAX : (1ull << off_bits) - 1;
+      vector<pair<uint64_t, expr>> vals;
+      for (auto &[idx, val] : data) {
+        if (full_write && val.eq(data[0].second))
+          continue;
+        vals.emplace_back(
+          (const_offset + (idx >> Pointer::zeroBitsShortOffset())) & mask,
+          val);
+      }
+      blk.storeConst(vals, full_write ? &mem : nullptr);
+      blk.undef.insert(undef.begin(), undef.end());
+      return;
+    }
+
     for (auto &[idx, val] : data) {
       if (full_write && val.eq(data[0].second))
         continue;
@@ -1095,28 +1170,42 @@ static expr mk_liveness_array() {
 }
 
 void Memory::mkNonlocalValAxioms(bool skip_consts) {
+  if (!does_ptr_mem_access &&
+      !(config::disable_poison_input && state->isSource() &&
+        does_int_mem_access))
+    return;
+
+  for (unsigned i = 0, e = numNonlocals(); i != e; ++i) {
+    val_axioms->vals.emplace(i, non_local_block_val[i].val);
+  }
+}
+
+void Memory::markAccessed(unsigned bid) const {
+  auto &accessed = val_axioms->accessed;
+  if (bid >= accessed.size())
+    accessed.resize(max(bid + 1, numNonlocals()));
+  accessed[bid] = true;
+}
+
+void Memory::mkNonlocalValAxioms(const vector<bool> &accessed) const {
   expr offset
     = expr::mkFreshVar("#off", expr::mkUInt(0, Pointer::bitsShortOffset()));
 
-  // Users may request the initial memory to be non-poisonous
-  if (config::disable_poison_input && state->isSource() &&
-      (does_int_mem_access || does_ptr_mem_access)) {
-    for (auto &block : non_local_block_val) {
-      if (isInitialMemBlock(block.val, config::disallow_ub_exploitation))
-        state->addAxiom(
-          expr::mkForAll({ offset },
-                         !Byte(*this, block.val.load(offset)).isPoison()));
-    }
-  }
+  for (auto &[i, val] : val_axioms->vals) {
+    if (i >= accessed.size() || !accessed[i])
+      continue;
 
-  if (!does_ptr_mem_access)
-    return;
+    // Users may request the initial memory to be non-poisonous
+    if (config::disable_poison_input && state->isSource() &&
+        (does_int_mem_access || does_ptr_mem_access) &&
+        isInitialMemBlock(val, config::disallow_ub_exploitation))
+      state->addAxiom(
+        expr::mkForAll({ offset }, !Byte(*this, val.load(offset)).isPoison()));
 
-  for (unsigned i = 0, e = numNonlocals(); i != e; ++i) {
-    if (always_noread(i, true))
+    if (!does_ptr_mem_access || always_noread(i, true))
       continue;
 
-    Byte byte(*this, non_local_block_val[i].val.load(offset));
+    Byte byte(*this, val.load(offset));
     Pointer loadedptr = byte.ptr();
     expr bid = loadedptr.getShortBid();
 
@@ -1146,7 +1235,9 @@ void Memory::mkNonlocalValAxioms(bool skip_consts) {
   }
 }
 
-Memory::Memory(State &state) : state(&state), escaped_local_blks(*this) {
+Memory::Memory(State &state)
+  : state(&state), escaped_local_blks(*this),
+    val_axioms(make_shared<LazyValAxioms>()) {
   if (memory_unused())
     return;
 
@@ -1192,6 +1283,17 @@ void Memory::mkAxioms(const Memory &tgt) const {
   if (memory_unused())
     return;
 
+  // a block accessed by one of the functions is compared with the other's
+  auto accessed = val_axioms->accessed;
+  auto &tgt_accessed = tgt.val_axioms->accessed;
+  accessed.resize(max(accessed.size(), tgt_accessed.size()));
+  for (unsigned i = 0, e = tgt_accessed.size(); i != e; ++i) {
+    if (tgt_accessed[i])
+      accessed[i] = true;
+  }
+  mkNonlocalValAxioms(accessed);
+  tgt.mkNonlocalValAxioms(accessed);
+
   auto skip_bid = [&](unsigned bid) {
     if (bid == 0 && has_null_block)
       return true;
@@ -1309,7 +1411,7 @@ expr Memory::mkInput(const char *name, const ParamAttrs &attrs) {
     state->addAxiom(bid != byval_bid);
     alias.setNoAlias(false, byval_bid);
   }
-  ptr_alias.emplace(p.getBid(), std::move(alias));
+  ptr_alias.write().emplace(p.getBid(), std::move(alias));
 
   return std::move(p).release();
 }
@@ -1418,7 +1520,7 @@ Memory::mkFnRet(const char *name0, const vector<PtrInput> &ptr_inputs,
     nonlocal &= bid != byval_bid;
     alias.setNoAlias(false, byval_bid);
   }
-  ptr_alias.emplace(p.getBid(), std::move(alias));
+  ptr_alias.write().emplace(p.getBid(), std::move(alias));
 
   state->addAxiom(expr::mkIf(p.isLocal(), local, nonlocal));
   return { std::move(p).release(), {} };
@@ -1499,7 +1601,8 @@ void Memory::setState(const Memory::CallState &st,
       = num_nonlocals_src - num_inaccessiblememonly_fns + inaccessible_bid;
     assert(bid < num_nonlocals_src);
     assert(non_local_block_val[bid].undef.empty());
-    non_local_block_val[bid].val = st.non_local_block_val[0];
+    non_local_block_val.write(bid).val = st.non_local_block_val[0];
+    markAccessed(bid);
   }
 
   if (access.canWrite(MemoryAccess::Args) &&
@@ -1520,10 +1623,13 @@ void Memory::setState(const Memory::CallState &st,
       }
 
       auto &new_val = st.non_local_block_val[idx++];
-      auto &cur_val = non_local_block_val[bid].val;
-      cur_val = expr::mkIf(modifies, new_val, cur_val);
+      if (modifies.isFalse())
+        continue;
+      auto &blk = non_local_block_val.write(bid);
+      blk.val = expr::mkIf(modifies, new_val, blk.val);
       if (modifies.isTrue())
-        non_local_block_val[bid].undef.clear();
+        blk.undef.clear();
+      markAccessed(bid);
     }
     assert(idx == st.non_local_block_val.size() - has_write_fncall);
   }
@@ -1537,8 +1643,10 @@ void Memory::setState(const Memory::CallState &st,
     for (unsigned bid = 0; bid < limit; ++bid) {
       if (always_nowrite(bid, true, true))
         continue;
-      non_local_block_val[bid].val = st.non_local_block_val[idx++];
-      non_local_block_val[bid].undef.clear();
+      auto &blk = non_local_block_val.write(bid);
+      blk.val = st.non_local_block_val[idx++];
+      blk.undef.clear();
+      markAccessed(bid);
     }
     assert(idx == st.non_local_block_val.size());
   }
@@ -1580,7 +1688,7 @@ void Memory::setState(const Memory::CallState &st,
 
     for (unsigned i = 0; i < next_local_bid; ++i) {
       if (escaped_local_blks.mayAlias(true, i)) {
-        local_block_val[i] = expr(array);
+        local_block_val.write(i) = expr(array);
       }
     }
   }
@@ -1861,17 +1969,17 @@ StateValue Memory::load(const Pointer &ptr, const Type &type, set<expr> &undef,
     for (auto &p : all_leaf_ptrs(*this, val.value)) {
       auto islocal = p.isLocal();
       auto bid = p.getShortBid();
-      if (!islocal.isTrue() && !bid.isConst()) {
-        auto [I, inserted] = ptr_alias.try_emplace(p.getBid(), *this);
-        if (inserted) {
-          if (!max_bid)
-            max_bid = nextNonlocalBid();
-          I->second.setMayAliasUpTo(false, *max_bid);
-          for (unsigned i = num_nonlocals_src; i < numNonlocals(); ++i) {
-            I->second.setMayAlias(false, i);
-          }
-          state->addPre(!val.non_poison || islocal || bid.ule(*max_bid));
+      if (!islocal.isTrue() && !bid.isConst() &&
+          !ptr_alias->count(p.getBid())) {
+        auto &alias
+          = ptr_alias.write().try_emplace(p.getBid(), *this).first->second;
+        if (!max_bid)
+          max_bid = nextNonlocalBid();
+        alias.setMayAliasUpTo(false, *max_bid);
+        for (unsigned i = num_nonlocals_src; i < numNonlocals(); ++i) {
+          alias.setMayAlias(false, i);
         }
+        state->addPre(!val.non_poison || islocal || bid.ule(*max_bid));
       }
     }
   }
@@ -2015,14 +2123,15 @@ void Memory::copy(const Pointer &src, const Pointer &dst) {
   bool dst_local = local.isTrue();
   uint64_t dst_bid;
   ENSURE(dst.getShortBid().isUInt(dst_bid));
-  auto &dst_blk = (dst_local ? local_block_val : non_local_block_val)[dst_bid];
+  auto &dst_blk
+    = (dst_local ? local_block_val : non_local_block_val).write(dst_bid);
   dst_blk.undef.clear();
   dst_blk.type = DATA_NONE;
 
   auto offset = expr::mkUInt(0, Pointer::bitsShortOffset());
   DisjointExpr val(expr::mkConstArray(offset, Byte::mkPoisonByte(*this)()));
 
-  auto fn = [&](MemBlock &blk, unsigned bid, bool local, expr &&cond) {
+  auto fn = [&](const MemBlock &blk, unsigned bid, bool local, expr &&cond) {
     // we assume src != dst
     if (local == dst_local && bid == dst_bid)
       return;
@@ -2282,6 +2391,7 @@ expr Memory::checkNocapture() const {
   for (unsigned bid = 0; bid < numNonlocals(); ++bid) {
     if (always_nowrite(bid))
       continue;
+    markAccessed(bid);
     Pointer p(*this, bid, false);
     Byte b(*this, non_local_block_val[bid].val.load(offset));
     Pointer loadp(*this, b.ptrValue());
@@ -2321,21 +2431,22 @@ void Memory::escapeLocalPtr(const expr &ptr, const expr &is_ptr) {
 Memory Memory::mkIf(const expr &cond, Memory &&then, Memory &&els) {
   assert(then.state == els.state);
   Memory &ret = then;
+  // blocks shared by both sides weren't written in either since the fork
+  auto merge = [&](MemBlocks &blocks, const MemBlocks &other, unsigned bid) {
+    if (blocks.sharedWith(other, bid))
+      return;
+    auto &blk = blocks.write(bid);
+    auto &other_blk = other[bid];
+    blk.val = expr::mkIf(cond, blk.val, other_blk.val);
+    blk.undef.insert(other_blk.undef.begin(), other_blk.undef.end());
+  };
   for (unsigned bid = 0, end = ret.numNonlocals(); bid < end; ++bid) {
     if (always_nowrite(bid, false, true))
       continue;
-    auto &other = els.non_local_block_val[bid];
-    ret.non_local_block_val[bid].val
-      = expr::mkIf(cond, then.non_local_block_val[bid].val, other.val);
-    ret.non_local_block_val[bid].undef.insert(other.undef.begin(),
-                                              other.undef.end());
+    merge(ret.non_local_block_val, els.non_local_block_val, bid);
   }
   for (unsigned bid = 0, end = ret.numLocals(); bid < end; ++bid) {
-    auto &other = els.local_block_val[bid];
-    ret.local_block_val[bid].val
-      = expr::mkIf(cond, then.local_block_val[bid].val, other.val);
-    ret.local_block_val[bid].undef.insert(other.undef.begin(),
-                                          other.undef.end());
+    merge(ret.local_block_val, els.local_block_val, bid);
   }
   ret.non_local_block_liveness = expr::mkIf(cond, then.non_local_block_liveness,
                                             els.non_local_block_liveness);
@@ -2350,10 +2461,13 @@ Memory Memory::mkIf(const expr &cond, Memory &&then, Memory &&els) {
   ret.non_local_blk_kind.add(els.non_local_blk_kind);
   ret.escaped_local_blks.unionWith(els.escaped_local_blks);
 
-  for (const auto &[expr, alias] : els.ptr_alias) {
-    auto [I, inserted] = ret.ptr_alias.try_emplace(expr, alias);
-    if (!inserted)
-      I->second.unionWith(alias);
+  if (!ret.ptr_alias.sharedWith(els.ptr_alias)) {
+    auto &ptr_alias = ret.ptr_alias.write();
+    for (const auto &[expr, alias] : *els.ptr_alias) {
+      auto [I, inserted] = ptr_alias.try_emplace(expr, alias);
+      if (!inserted)
+        I->second.unionWith(alias);
+    }
   }
 
   ret.next_nonlocal_bid = max(then.next_nonlocal_bid, els.next_nonlocal_bid);
@@ -2441,11 +2555,11 @@ ostream& operator<<(ostream &os, const Memory &m) {
   if (!m.local_blk_addr.empty()) {
     os << "\nLOCAL BLOCK ADDR: " << m.local_blk_addr << '\n';
   }
-  if (!m.ptr_alias.empty()) {
+  if (!m.ptr_alias->empty()) {
     os << "\nALIAS SETS:\n";
-    for (auto &[bid, alias] : m.ptr_alias) {
-      os << bid << ": ";
-      alias.print(os);
+    for (auto *p : m.ptr_alias->sorted()) {
+      os << p->first << ": ";
+      p->second.print(os);
       os << '\n';
     }
   }
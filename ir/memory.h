@@ -9,12 +9,16 @@
 #include "ir/type.h"
 #include "smt/expr.h"
 #include "smt/exprs.h"
+#include "util/bitset.h"
+#include "util/cow.h"
 #include "util/spaceship.h"
 #include <compare>
 #include <map>
+#include <memory>
 #include <optional>
 #include <ostream>
 #include <set>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -87,7 +91,7 @@ class Memory {
   State *state;
 
   class AliasSet {
-    std::vector<bool> local, non_local;
+    util::SmallBitSet local, non_local;
 
   public:
     AliasSet(const Memory &m); // no alias
@@ -123,16 +127,54 @@ class Memory {
     std::set<smt::expr> undef;
     unsigned char type = DATA_ANY;
 
+    // Bytes stored at constant offsets on top of writes_base. val is kept
+    // as one store per offset, in offset order. The map is only used while
+    // val is still writes_val; any other update of val invalidates it.
+    std::map<uint64_t, smt::expr> writes;
+    smt::expr writes_base, writes_val;
+
     MemBlock() {}
     MemBlock(smt::expr &&val) : val(std::move(val)) {}
     MemBlock(smt::expr &&val, DataType type)
       : val(std::move(val)), type(type) {}
 
+    smt::expr load(const smt::expr &offset) const;
+    // Pre: cond of the store is true and all offsets are constant
+    void storeConst(const std::vector<std::pair<uint64_t, smt::expr>> &data,
+                    smt::expr *base = nullptr);
+
     std::weak_ordering operator<=>(const MemBlock &rhs) const;
   };
 
-  std::vector<MemBlock> non_local_block_val;
-  std::vector<MemBlock> local_block_val;
+  // Copies of the memory (e.g., one per CFG edge) share the list and the
+  // blocks that weren't written since.
+  class MemBlocks {
+    util::COW<std::vector<util::COW<MemBlock>>> blocks;
+
+  public:
+    unsigned size() const { return blocks->size(); }
+    const MemBlock& operator[](unsigned i) const { return *(*blocks)[i]; }
+    MemBlock& write(unsigned i) { return blocks.write()[i].write(); }
+    // true if block i is the same object in both
+    bool sharedWith(const MemBlocks &other, unsigned i) const {
+      return blocks.sharedWith(other.blocks) ||
+             (*blocks)[i].sharedWith((*other.blocks)[i]);
+    }
+
+    template <typename... Args>
+    void emplace_back(Args&&... args) {
+      blocks.write().emplace_back(MemBlock(std::forward<Args>(args)...));
+    }
+    void resize(unsigned n, const MemBlock &blk = {}) {
+      blocks.write().resize(n, blk);
+    }
+    void clear() { blocks.write().clear(); }
+
+    auto operator<=>(const MemBlocks &rhs) const = default;
+  };
+
+  MemBlocks non_local_block_val;
+  MemBlocks local_block_val;
 
   smt::expr non_local_block_liveness; // BV w/ 1 bit per bid (1 if live)
   smt::expr local_block_liveness;
@@ -153,7 +195,26 @@ class Memory {
     return escaped_local_blks.numMayAlias(true) > 0;
   }
 
-  std::map<smt::expr, AliasSet> ptr_alias; // blockid -> alias
+  struct ExprHash {
+    size_t operator()(const smt::expr &e) const { return e.hash(); }
+  };
+  struct ExprEq {
+    bool operator()(const smt::expr &a, const smt::expr &b) const {
+      return a.eq(b);
+    }
+  };
+
+  // blockid -> alias
+  // Looked up on every access; only ordered when comparing whole memories.
+  // Not a sorted vector: ordering exprs costs a call into Z3 per comparison,
+  // while the hash is computed once per lookup.
+  class AliasMap
+    : public std::unordered_map<smt::expr, AliasSet, ExprHash, ExprEq> {
+  public:
+    std::vector<const value_type*> sorted() const;
+    std::weak_ordering operator<=>(const AliasMap &rhs) const;
+  };
+  util::COW<AliasMap> ptr_alias;
   unsigned next_nonlocal_bid = 0;
   unsigned nextNonlocalBid();
 
@@ -165,7 +226,19 @@ class Memory {
 
   smt::expr isBlockAlive(const smt::expr &bid, bool local) const;
 
+  // The axioms over the contents of non-local blocks only matter for the
+  // blocks whose contents are touched. They are recorded when a block gets a
+  // new value and emitted by mkAxioms for the blocks accessed by either
+  // function. Shared by all copies of the memory of a state.
+  struct LazyValAxioms {
+    std::set<std::pair<unsigned, smt::expr>> vals; // <bid, block value>
+    std::vector<bool> accessed; // non-local bid -> contents read or written
+  };
+  std::shared_ptr<LazyValAxioms> val_axioms;
+
   void mkNonlocalValAxioms(bool skip_consts);
+  void mkNonlocalValAxioms(const std::vector<bool> &accessed) const;
+  void markAccessed(unsigned bid) const;
 
   bool mayalias(bool local, unsigned bid, const smt::expr &offset,
                 unsigned bytes, uint64_t align, bool write) const;
@@ -0,0 +1,860 @@
+// Copyright (c) 2018-present The Alive2 Authors.
+// Distributed under the MIT license that can be found in the LICENSE file.
+
+#include "ir/x86_intrinsics.h"
+#include "ir/type.h"
+#include "smt/expr.h"
+#include "util/compiler.h"
+#include "util/config.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+
+using namespace IR;
+using namespace smt;
+using namespace util;
+using namespace std;
+
+namespace {
+
+uint64_t trunc(uint64_t v, unsigned bits) {
+  return bits >= 64 ? v : v & ((uint64_t(1) << bits) - 1);
+}
+
+int64_t sext(uint64_t v, unsigned bits) {
+  return bits >= 64 ? (int64_t)v : (int64_t)(v << (64 - bits)) >> (64 - bits);
+}
+
+uint64_t saturate(int64_t v, int64_t min, int64_t max, unsigned bits) {
+  return trunc(std::clamp(v, min, max), bits);
+}
+
+int64_t smin(unsigned bits) { return -(int64_t(1) << (bits - 1)); }
+int64_t smax(unsigned bits) { return (int64_t(1) << (bits - 1)) - 1; }
+int64_t umax(unsigned bits) { return (int64_t(1) << bits) - 1; }
+
+uint64_t get_bits(const vector<uint64_t> &words, unsigned low, unsigned bits) {
+  uint64_t v = words[low / 64] >> (low % 64);
+  if (low % 64 + bits > 64)
+    v |= words[low / 64 + 1] << (64 - low % 64);
+  return trunc(v, bits);
+}
+
+void set_bits(vector<uint64_t> &words, unsigned low, unsigned bits,
+              uint64_t v) {
+  words[low / 64] |= v << (low % 64);
+  if (low % 64 + bits > 64)
+    words[low / 64 + 1] |= v >> (64 - low % 64);
+}
+
+
+// Shapes of the result and operands as <# of lanes, element bits>, taken
+// from the intrinsics tables. A single lane means a scalar.
+template <unsigned RL, unsigned RB, unsigned AL, unsigned AB,
+          unsigned BL, unsigned BB, unsigned CL = 0, unsigned CB = 0,
+          unsigned DL = 0, unsigned DB = 0>
+struct Shape {
+  static constexpr unsigned ret_lanes = RL, ret_bits = RB;
+  static constexpr unsigned a_lanes = AL, a_bits = AB;
+  static constexpr unsigned b_lanes = BL, b_bits = BB;
+  static constexpr unsigned c_lanes = CL, c_bits = CB;
+  static constexpr unsigned d_lanes = DL, d_bits = DB;
+  static constexpr pair<unsigned, unsigned> ret = { RL, RB };
+};
+
+// Lane i of a vector of L lanes with W bits each, as in
+// AggregateType::extract. Lane 0 is the most significant one.
+template <unsigned L, unsigned W>
+StateValue lane(const StateValue &v, unsigned i) {
+  if constexpr (L == 1) {
+    return v;
+  } else {
+    unsigned high = (L - i) * W - 1;
+    unsigned np = L - i - 1;
+    return { v.value.extract(high, high - W + 1),
+             v.non_poison.extract(np, np) == expr::mkInt(-1, 1) };
+  }
+}
+
+// Same as above, but with a symbolic index, as in VectorType::extract.
+template <unsigned L, unsigned W>
+StateValue lane(const StateValue &v, const expr &idx) {
+  expr idx_v = idx.zextOrTrunc(L * W) * expr::mkUInt(W, L * W);
+  expr idx_np = idx.zextOrTrunc(L);
+  return { (v.value << idx_v).extract(L * W - 1, (L - 1) * W),
+           (v.non_poison << idx_np).extract(L - 1, L - 1)
+             == expr::mkInt(-1, 1) };
+}
+
+// The inverse of lane(), as in AggregateType::aggregateVals.
+template <unsigned L>
+StateValue aggregate(const array<StateValue, L> &vals) {
+  if constexpr (L == 1) {
+    return vals[0];
+  } else {
+    StateValue v;
+    for (unsigned i = 0; i != L; ++i) {
+      StateValue vv(expr(vals[i].value), vals[i].non_poison.toBVBool());
+      v = i == 0 ? std::move(vv) : v.concat(vv);
+    }
+    return v;
+  }
+}
+
+// Select vals[idx % N] with a tree of ites on the index bits. This is much
+// easier on the solver than shifting the whole vector by a symbolic amount.
+template <unsigned N>
+StateValue mux(array<StateValue, N> vals, const expr &idx) {
+  static_assert((N & (N - 1)) == 0);
+  for (unsigned bit = 0, n = N; n != 1; ++bit, n /= 2) {
+    expr sel = idx.extract(bit, bit) == 1;
+    for (unsigned k = 0; k != n / 2; ++k) {
+      vals[k] = StateValue::mkIf(sel, vals[2 * k + 1], vals[2 * k]);
+    }
+  }
+  return std::move(vals[0]);
+}
+
+// Sums vals with a balanced tree of additions rather than a chain, which
+// keeps the carry chains of the bit-blasted adders short.
+expr add_tree(vector<expr> vals) {
+  while (vals.size() > 1) {
+    vector<expr> next;
+    for (unsigned i = 0; i + 1 < vals.size(); i += 2) {
+      next.emplace_back(vals[i] + vals[i + 1]);
+    }
+    if (vals.size() % 2)
+      next.emplace_back(std::move(vals.back()));
+    vals = std::move(next);
+  }
+  return std::move(vals[0]);
+}
+
+
+// Lane combinators. Each has an SMT version and a native version over
+// constants; the two must agree. Those that are simple expressions over the
+// lanes are written in ir/x86_intrinsics.spec instead.
+
+// acc + the sum of the products of the N elements packed in each dword of a
+// and b, optionally with signed saturation
+template <unsigned N, bool ASigned, bool Sat>
+struct DotProduct {
+  static constexpr unsigned w = 32 / N;
+  // wide enough for the exact sum when saturating
+  static constexpr unsigned bw = Sat ? 34 : 32;
+
+  static expr smt(const expr &acc, const expr &a, const expr &b) {
+    vector<expr> terms = { acc.sext(bw - 32) };
+    for (unsigned k = 0; k != N; ++k) {
+      expr ak = a.extract(w * k + w - 1, w * k);
+      expr bk = b.extract(w * k + w - 1, w * k);
+      // the product is exact in 2w bits; only extend it afterwards
+      expr p = (ASigned ? ak.sext(w) : ak.zext(w)) * bk.sext(w);
+      terms.emplace_back(p.sext(bw - 2 * w));
+    }
+    expr sum = add_tree(std::move(terms));
+    if (!Sat)
+      return sum;
+
+    auto min = expr::IntSMin(32);
+    auto max = expr::IntSMax(32);
+    return expr::mkIf(sum.sle(min.sext(bw - 32)), min,
+                      expr::mkIf(sum.sge(max.sext(bw - 32)), max,
+                                 sum.trunc(32)));
+  }
+  static uint64_t eval(uint64_t acc, uint64_t a, uint64_t b, unsigned) {
+    int64_t sum = sext(acc, 32);
+    for (unsigned k = 0; k != N; ++k) {
+      uint64_t ak = trunc(a >> (w * k), w);
+      uint64_t bk = trunc(b >> (w * k), w);
+      sum += (ASigned ? sext(ak, w) : int64_t(ak)) * sext(bk, w);
+    }
+    return Sat ? saturate(sum, smin(32), smax(32), 32) : trunc(sum, 32);
+  }
+};
+
+// acc + the low or high 52 bits of the 104-bit product of the low 52 bits
+// of a and b
+template <bool High>
+struct MAdd52 {
+  static expr smt(const expr &acc, const expr &a, const expr &b) {
+    expr p = a.extract(51, 0).zext(52) * b.extract(51, 0).zext(52);
+    return acc + (High ? p.extract(103, 52) : p.extract(51, 0)).zext(12);
+  }
+  static uint64_t eval(uint64_t acc, uint64_t a, uint64_t b, unsigned) {
+    // multiply in 26-bit limbs to avoid needing a 128-bit type
+    uint64_t a0 = trunc(a, 26), a1 = trunc(a >> 26, 26);
+    uint64_t b0 = trunc(b, 26), b1 = trunc(b >> 26, 26);
+    uint64_t mid = a0 * b1 + a1 * b0;
+    uint64_t lo = a0 * b0 + (trunc(mid, 26) << 26);
+    uint64_t hi = a1 * b1 + (mid >> 26) + (lo >> 52);
+    return acc + (High ? hi : trunc(lo, 52));
+  }
+};
+
+
+// Kernels. Each one gives the lane structure of a family of intrinsics and
+// is instantiated per intrinsic with its shapes.
+// chunk<S> is the lane-dependency metadata returned by x86_lane_chunk().
+
+// The shift amount of psrl/psra/psll and their immediate forms may be wider
+// or narrower than the element. Amounts >= the element width have the same
+// result as the width itself.
+expr shift_amount(const expr &amount, unsigned bw) {
+  return expr::mkIf(amount.uge(expr::mkUInt(bw, amount)),
+                    expr::mkUInt(bw, bw), amount.zextOrTrunc(bw));
+}
+
+// result lane i = Op(a[i], amount), where amount is the lower 64 bits of b
+template <typename Op>
+struct ShiftByVector {
+  // every lane depends on the first lanes of the vector b
+  template <typename S>
+  static constexpr unsigned chunk = 0;
+
+  template <typename S>
+  static StateValue smt(const StateValue &a, const StateValue &b) {
+    expr amount, amount_np = true;
+    for (unsigned i = 0; i != 64 / S::b_bits; ++i) {
+      auto [v, np] = lane<S::b_lanes, S::b_bits>(b, i);
+      amount = i == 0 ? std::move(v) : v.concat(amount);
+      // if any elements in lower 64 bits is poison, the result is poison
+      amount_np &= np;
+    }
+    amount = shift_amount(amount, S::a_bits);
+    array<StateValue, S::ret_lanes> vals;
+    for (unsigned i = 0; i != S::ret_lanes; ++i) {
+      auto [v, np] = lane<S::a_lanes, S::a_bits>(a, i);
+      vals[i] = { Op::smt(v, amount), amount_np && np };
+    }
+    return aggregate<S::ret_lanes>(vals);
+  }
+
+  template <typename S>
+  static X86ConstVector eval(const X86ConstVector &a,
+                             const X86ConstVector &b) {
+    X86ConstVector r(S::ret);
+    uint64_t amount = 0;
+    bool amount_np = true;
+    for (unsigned i = 0; i != 64 / S::b_bits; ++i) {
+      amount |= b.lanes[i] << (i * S::b_bits);
+      amount_np &= b.non_poison[i];
+    }
+    for (unsigned i = 0; i != S::ret_lanes; ++i) {
+      r.lanes.emplace_back(Op::eval(a.lanes[i], amount, S::a_bits));
+      r.non_poison.emplace_back(amount_np && a.non_poison[i]);
+    }
+    return r;
+  }
+};
+
+// result lane i = Op(a[i], b), where b is a scalar
+template <typename Op>
+struct ShiftByScalar {
+  template <typename S>
+  static constexpr unsigned chunk = S::ret_bits;
+
+  template <typename S>
+  static StateValue smt(const StateValue &a, const StateValue &b) {
+    expr amount = shift_amount(b.value, S::a_bits);
+    array<StateValue, S::ret_lanes> vals;
+    for (unsigned i = 0; i != S::ret_lanes; ++i) {
+      auto [v, np] = lane<S::a_lanes, S::a_bits>(a, i);
+      vals[i] = { Op::smt(v, amount), np && b.non_poison };
+    }
+    return aggregate<S::ret_lanes>(vals);
+  }
+
+  template <typename S>
+  static X86ConstVector eval(const X86ConstVector &a,
+                             const X86ConstVector &b) {
+    X86ConstVector r(S::ret);
+    for (unsigned i = 0; i != S::ret_lanes; ++i) {
+      r.lanes.emplace_back(Op::eval(a.lanes[i], b.lanes[0], S::a_bits));
+      r.non_poison.emplace_back(a.non_poison[i] && b.non_poison[0]);
+    }
+    return r;
+  }
+};
+
+// result lane i = Op(a[i], b[i])
+template <typename Op>
+struct Vertical {
+  template <typename S>
+  static constexpr unsigned chunk = S::ret_bits;
+
+  template <typename S>
+  static StateValue smt(const StateValue &a, const StateValue &b) {
+    array<StateValue, S::ret_lanes> vals;
+    for (unsigned i = 0; i != S::ret_lanes; ++i) {
+      auto [av, ap] = lane<S::a_lanes, S::a_bits>(a, i);
+      auto [bv, bp] = lane<S::b_lanes, S::b_bits>(b, i);
+      vals[i] = { Op::smt(av, bv), ap && bp };
+    }
+    return aggregate<S::ret_lanes>(vals);
+  }
+
+  template <typename S>
+  static X86ConstVector eval(const X86ConstVector &a,
+                             const X86ConstVector &b) {
+    X86ConstVector r(S::ret);
+    for (unsigned i = 0; i != S::ret_lanes; ++i) {
+      r.lanes.emplace_back(Op::eval(a.lanes[i], b.lanes[i], S::ret_bits));
+      r.non_poison.emplace_back(a.non_poison[i] && b.non_poison[i]);
+    }
+    return r;
+  }
+};
+
+// Op over adjacent pairs of each 128-bit group of a, followed by those of b
+template <typename Op>
+struct Horizontal {
+  template <typename S>
+  static constexpr unsigned chunk = 128;
+
+  template <typename S>
+  static StateValue smt(const StateValue &a, const StateValue &b) {
+    constexpr unsigned groupsize = 128 / S::ret_bits;
+    array<StateValue, S::ret_lanes> vals;
+    unsigned k = 0;
+    for (unsigned j = 0; j != S::ret_lanes / groupsize; ++j) {
+      for (auto *v : { &a, &b }) {
+        for (unsigned i = 0; i != groupsize; i += 2) {
+          auto [v1, p1] = lane<S::a_lanes, S::a_bits>(*v, j * groupsize + i);
+          auto [v2, p2]
+            = lane<S::a_lanes, S::a_bits>(*v, j * groupsize + i + 1);
+          vals[k++] = { Op::smt(v1, v2), p1 && p2 };
+        }
+      }
+    }
+    return aggregate<S::ret_lanes>(vals);
+  }
+
+  template <typename S>
+  static X86ConstVector eval(const X86ConstVector &a,
+                             const X86ConstVector &b) {
+    constexpr unsigned groupsize = 128 / S::ret_bits;
+    X86ConstVector r(S::ret);
+    for (unsigned j = 0; j != S::ret_lanes / groupsize; ++j) {
+      for (auto *v : { &a, &b }) {
+        for (unsigned i = 0; i != groupsize; i += 2) {
+          unsigned idx = j * groupsize + i;
+          r.lanes.emplace_back(Op::eval(v->lanes[idx], v->lanes[idx + 1],
+                                        S::ret_bits));
+          r.non_poison.emplace_back(v->non_poison[idx] &&
+                                    v->non_poison[idx + 1]);
+        }
+      }
+    }
+    return r;
+  }
+};
+
+// each 128-bit group of a, followed by that of b, narrowed with Op
+template <typename Op>
+struct Pack {
+  template <typename S>
+  static constexpr unsigned chunk = 128;
+
+  template <typename S>
+  static StateValue smt(const StateValue &a, const StateValue &b) {
+    constexpr unsigned groupsize = 128 / S::b_bits;
+    array<StateValue, S::ret_lanes> vals;
+    unsigned k = 0;
+    for (unsigned j = 0; j != S::b_lanes / groupsize; ++j) {
+      for (auto *v : { &a, &b }) {
+        for (unsigned i = 0; i != groupsize; ++i) {
+          auto [v1, p1] = lane<S::a_lanes, S::a_bits>(*v, j * groupsize + i);
+          vals[k++] = { Op::smt(v1), std::move(p1) };
+        }
+      }
+    }
+    return aggregate<S::ret_lanes>(vals);
+  }
+
+  template <typename S>
+  static X86ConstVector eval(const X86ConstVector &a,
+                             const X86ConstVector &b) {
+    constexpr unsigned groupsize = 128 / S::b_bits;
+    X86ConstVector r(S::ret);
+    for (unsigned j = 0; j != S::b_lanes / groupsize; ++j) {
+      for (auto *v : { &a, &b }) {
+        for (unsigned i = 0; i != groupsize; ++i) {
+          unsigned idx = j * groupsize + i;
+          r.lanes.emplace_back(Op::eval(sext(v->lanes[idx], S::a_bits),
+                                        S::ret_bits));
+          r.non_poison.emplace_back(v->non_poison[idx]);
+        }
+      }
+    }
+    return r;
+  }
+};
+
+// result lane i = Op(a[2i], a[2i+1], b[2i], b[2i+1])
+template <typename Op>
+struct MultiplyAdd {
+  template <typename S>
+  static constexpr unsigned chunk = S::ret_bits;
+
+  template <typename S>
+  static StateValue smt(const StateValue &a, const StateValue &b) {
+    array<StateValue, S::ret_lanes> vals;
+    for (unsigned i = 0; i != S::ret_lanes; ++i) {
+      auto [a1, a1p] = lane<S::a_lanes, S::a_bits>(a, i * 2);
+      auto [a2, a2p] = lane<S::a_lanes, S::a_bits>(a, i * 2 + 1);
+      auto [b1, b1p] = lane<S::b_lanes, S::b_bits>(b, i * 2);
+      auto [b2, b2p] = lane<S::b_lanes, S::b_bits>(b, i * 2 + 1);
+      vals[i] = { Op::smt(a1, a2, b1, b2), a1p && a2p && b1p && b2p };
+    }
+    return aggregate<S::ret_lanes>(vals);
+  }
+
+  template <typename S>
+  static X86ConstVector eval(const X86ConstVector &a,
+                             const X86ConstVector &b) {
+    X86ConstVector r(S::ret);
+    for (unsigned i = 0; i != S::ret_lanes; ++i) {
+      r.lanes.emplace_back(Op::eval(a.lanes[i * 2], a.lanes[i * 2 + 1],
+                                    b.lanes[i * 2], b.lanes[i * 2 + 1],
+                                    S::a_bits));
+      r.non_poison.emplace_back(a.non_poison[i * 2] &&
+                                a.non_poison[i * 2 + 1] &&
+                                b.non_poison[i * 2] &&
+                                b.non_poison[i * 2 + 1]);
+    }
+    return r;
+  }
+};
+
+// result lane j = sum of |a[i] - b[i]| over the j-th group of 8 lanes
+struct SumAbsDiff {
+  template <typename S>
+  static constexpr unsigned chunk = S::ret_bits;
+
+  template <typename S>
+  static StateValue smt(const StateValue &a, const StateValue &b) {
+    array<StateValue, S::ret_lanes> vals;
+    for (unsigned j = 0; j != S::ret_lanes; ++j) {
+      expr np = true;
+      vector<expr> diffs;
+      for (unsigned i = 0; i != 8; ++i) {
+        auto [av, ap] = lane<S::a_lanes, S::a_bits>(a, 8 * j + i);
+        auto [bv, bp] = lane<S::b_lanes, S::b_bits>(b, 8 * j + i);
+        np = np && ap && bp;
+        // |a - b| of unsigned bytes fits in a byte; the sum of 8 in 11 bits
+        diffs.emplace_back(expr::mkIf(av.uge(bv), av - bv, bv - av).zext(3));
+      }
+      expr v = add_tree(std::move(diffs));
+      vals[j] = { v.zext(S::ret_bits - v.bits()), std::move(np) };
+    }
+    return aggregate<S::ret_lanes>(vals);
+  }
+
+  template <typename S>
+  static X86ConstVector eval(const X86ConstVector &a,
+                             const X86ConstVector &b) {
+    X86ConstVector r(S::ret);
+    for (unsigned j = 0; j != S::ret_lanes; ++j) {
+      uint64_t sum = 0;
+      bool np = true;
+      for (unsigned i = 0; i != 8; ++i) {
+        unsigned idx = 8 * j + i;
+        sum += (uint64_t)abs(int64_t(a.lanes[idx]) - int64_t(b.lanes[idx]));
+        np = np && a.non_poison[idx] && b.non_poison[idx];
+      }
+      r.lanes.emplace_back(sum);
+      r.non_poison.emplace_back(np);
+    }
+    return r;
+  }
+};
+
+// byte shuffle within each 128-bit group; bit 7 of the index zeroes the lane
+struct ShuffleBytes {
+  template <typename S>
+  static constexpr unsigned chunk = 128;
+
+  template <typename S>
+  static StateValue smt(const StateValue &a, const StateValue &b) {
+    array<StateValue, S::ret_lanes> vals;
+    array<StateValue, 16> group;
+    for (unsigned i = 0; i != S::ret_lanes; ++i) {
+      auto [bv, bp] = lane<S::b_lanes, S::b_bits>(b, i);
+      StateValue rv;
+      if (config::x86_shuffle_mux) {
+        if (i % 16 == 0) {
+          for (unsigned k = 0; k != 16; ++k) {
+            group[k] = lane<S::a_lanes, S::a_bits>(a, i + k);
+          }
+        }
+        rv = mux<16>(group, bv);
+      } else {
+        expr id = (bv & expr::mkUInt(0x0F, 8)) + expr::mkUInt(i & 0x30, 8);
+        rv = lane<S::a_lanes, S::a_bits>(a, id);
+      }
+      auto &[r, rp] = rv;
+      auto v = expr::mkIf(bv.extract(7, 7) == expr::mkUInt(0, 1), r,
+                          expr::mkUInt(0, 8));
+      vals[i] = { std::move(v), bp && rp };
+    }
+    return aggregate<S::ret_lanes>(vals);
+  }
+
+  template <typename S>
+  static X86ConstVector eval(const X86ConstVector &a,
+                             const X86ConstVector &b) {
+    X86ConstVector r(S::ret);
+    for (unsigned i = 0; i != S::ret_lanes; ++i) {
+      uint64_t idx = trunc((b.lanes[i] & 0x0F) + (i & 0x30), 8);
+      r.lanes.emplace_back((b.lanes[i] & 0x80) ? 0 : a.lanes[idx]);
+      r.non_poison.emplace_back(b.non_poison[i] && a.non_poison[idx]);
+    }
+    return r;
+  }
+};
+
+// result lane i = bit 7 of c[i] ? b[i] : a[i]
+struct BlendBytes {
+  template <typename S>
+  static constexpr unsigned chunk = S::ret_bits;
+
+  template <typename S>
+  static StateValue smt(const StateValue &a, const StateValue &b,
+                        const StateValue &c) {
+    array<StateValue, S::ret_lanes> vals;
+    for (unsigned i = 0; i != S::ret_lanes; ++i) {
+      auto [av, ap] = lane<S::a_lanes, S::a_bits>(a, i);
+      auto [bv, bp] = lane<S::b_lanes, S::b_bits>(b, i);
+      auto [cv, cp] = lane<S::c_lanes, S::c_bits>(c, i);
+      auto v = expr::mkIf(cv.extract(7, 7) == expr::mkUInt(0, 1), av, bv);
+      vals[i] = { std::move(v), ap && bp && cp };
+    }
+    return aggregate<S::ret_lanes>(vals);
+  }
+
+  template <typename S>
+  static X86ConstVector eval(const X86ConstVector &a, const X86ConstVector &b,
+                             const X86ConstVector &c) {
+    X86ConstVector r(S::ret);
+    for (unsigned i = 0; i != S::ret_lanes; ++i) {
+      r.lanes.emplace_back((c.lanes[i] & 0x80) ? b.lanes[i] : a.lanes[i]);
+      r.non_poison.emplace_back(a.non_poison[i] && b.non_poison[i] &&
+                                c.non_poison[i]);
+    }
+    return r;
+  }
+};
+
+// result lane i = Op(a[i], b[i], c[i])
+template <typename Op>
+struct Vertical3 {
+  template <typename S>
+  static constexpr unsigned chunk = S::ret_bits;
+
+  template <typename S>
+  static StateValue smt(const StateValue &a, const StateValue &b,
+                        const StateValue &c) {
+    array<StateValue, S::ret_lanes> vals;
+    for (unsigned i = 0; i != S::ret_lanes; ++i) {
+      auto [av, ap] = lane<S::a_lanes, S::a_bits>(a, i);
+      auto [bv, bp] = lane<S::b_lanes, S::b_bits>(b, i);
+      auto [cv, cp] = lane<S::c_lanes, S::c_bits>(c, i);
+      vals[i] = { Op::smt(av, bv, cv), ap && bp && cp };
+    }
+    return aggregate<S::ret_lanes>(vals);
+  }
+
+  template <typename S>
+  static X86ConstVector eval(const X86ConstVector &a, const X86ConstVector &b,
+                             const X86ConstVector &c) {
+    X86ConstVector r(S::ret);
+    for (unsigned i = 0; i != S::ret_lanes; ++i) {
+      r.lanes.emplace_back(Op::eval(a.lanes[i], b.lanes[i], c.lanes[i],
+                                    S::ret_bits));
+      r.non_poison.emplace_back(a.non_poison[i] && b.non_poison[i] &&
+                                c.non_poison[i]);
+    }
+    return r;
+  }
+};
+
+// Two-table permute: result lane i = (a ++ b)[idx[i] % 2L], where L is the
+// number of lanes. Operands are (a, idx, b).
+struct Permute2 {
+  template <typename S>
+  static constexpr unsigned chunk = 0;
+
+  template <typename S>
+  static StateValue smt(const StateValue &a, const StateValue &idx,
+                        const StateValue &b) {
+    constexpr unsigned L = S::ret_lanes, W = S::ret_bits;
+    array<StateValue, 2 * L> table;
+    if (config::x86_shuffle_mux) {
+      for (unsigned k = 0; k != L; ++k) {
+        table[k] = lane<L, W>(a, k);
+        table[L + k] = lane<L, W>(b, k);
+      }
+    }
+    StateValue ab = a.concat(b);
+
+    array<StateValue, L> vals;
+    for (unsigned i = 0; i != L; ++i) {
+      auto [iv, ip] = lane<L, W>(idx, i);
+      auto [r, rp] = config::x86_shuffle_mux
+                       ? mux<2 * L>(table, iv)
+                       : lane<2 * L, W>(ab, iv & expr::mkUInt(2 * L - 1, W));
+      vals[i] = { std::move(r), ip && rp };
+    }
+    return aggregate<L>(vals);
+  }
+
+  template <typename S>
+  static X86ConstVector eval(const X86ConstVector &a, const X86ConstVector &idx,
+                             const X86ConstVector &b) {
+    constexpr unsigned L = S::ret_lanes;
+    X86ConstVector r(S::ret);
+    for (unsigned i = 0; i != L; ++i) {
+      uint64_t j = idx.lanes[i] % (2 * L);
+      auto &src = j < L ? a : b;
+      r.lanes.emplace_back(src.lanes[j % L]);
+      r.non_poison.emplace_back(idx.non_poison[i] && src.non_poison[j % L]);
+    }
+    return r;
+  }
+};
+
+// Bitwise ternary logic: bit k of the result is bit (a_k b_k c_k) of the
+// immediate d. Since it is bitwise, it works on the whole vector at once.
+struct TernaryLogic {
+  template <typename S>
+  static constexpr unsigned chunk = S::ret_bits;
+
+  template <typename S>
+  static StateValue smt(const StateValue &a, const StateValue &b,
+                        const StateValue &c, const StateValue &d) {
+    unsigned bw = S::ret_lanes * S::ret_bits;
+    expr r = expr::mkUInt(0, bw);
+    for (unsigned k = 0; k != 8; ++k) {
+      expr m = (k & 4 ? a.value : ~a.value) &
+               (k & 2 ? b.value : ~b.value) &
+               (k & 1 ? c.value : ~c.value);
+      r = r | expr::mkIf(d.value.extract(k, k) == 1, m, expr::mkUInt(0, bw));
+    }
+
+    // a, b and c share the poison layout of the result; d is a scalar
+    expr np;
+    if constexpr (S::ret_lanes != 1)
+      np = expr::mkIf(d.non_poison,
+                      a.non_poison & b.non_poison & c.non_poison,
+                      expr::mkUInt(0, S::ret_lanes));
+    else
+      np = a.non_poison && b.non_poison && c.non_poison && d.non_poison;
+    return { std::move(r), std::move(np) };
+  }
+
+  template <typename S>
+  static X86ConstVector eval(const X86ConstVector &a, const X86ConstVector &b,
+                             const X86ConstVector &c,
+                             const X86ConstVector &d) {
+    X86ConstVector r(S::ret);
+    uint64_t imm = d.lanes[0];
+    for (unsigned i = 0; i != S::ret_lanes; ++i) {
+      uint64_t v = 0;
+      for (unsigned k = 0; k != 8; ++k) {
+        if ((imm >> k) & 1)
+          v |= (k & 4 ? a.lanes[i] : ~a.lanes[i]) &
+               (k & 2 ? b.lanes[i] : ~b.lanes[i]) &
+               (k & 1 ? c.lanes[i] : ~c.lanes[i]);
+      }
+      r.lanes.emplace_back(trunc(v, S::ret_bits));
+      r.non_poison.emplace_back(a.non_poison[i] && b.non_poison[i] &&
+                                c.non_poison[i] && d.non_poison[0]);
+    }
+    return r;
+  }
+};
+
+
+// The element operations written in ir/x86_intrinsics.spec and the kernels
+// referenced by the KIND column of the intrinsics tables
+#include "ir/x86_intrinsics_gen.h"
+
+using BinOpEncoder = StateValue(*)(const StateValue&, const StateValue&);
+using BinOpEvaluator = X86ConstVector(*)(const X86ConstVector&,
+                                         const X86ConstVector&);
+using TerOpEncoder = StateValue(*)(const StateValue&, const StateValue&,
+                                   const StateValue&);
+using TerOpEvaluator = X86ConstVector(*)(const X86ConstVector&,
+                                         const X86ConstVector&,
+                                         const X86ConstVector&);
+using QuadOpEncoder = StateValue(*)(const StateValue&, const StateValue&,
+                                    const StateValue&, const StateValue&);
+using QuadOpEvaluator = X86ConstVector(*)(const X86ConstVector&,
+                                          const X86ConstVector&,
+                                          const X86ConstVector&,
+                                          const X86ConstVector&);
+
+constexpr BinOpEncoder binop_encoders[] = {
+#define PROCESS(NAME,KIND,A,B,C,D,E,F) &KIND::smt<Shape<A,B,C,D,E,F>>,
+#include "ir/intrinsics_binop.h"
+#undef PROCESS
+};
+
+constexpr BinOpEvaluator binop_evaluators[] = {
+#define PROCESS(NAME,KIND,A,B,C,D,E,F) &KIND::eval<Shape<A,B,C,D,E,F>>,
+#include "ir/intrinsics_binop.h"
+#undef PROCESS
+};
+
+constexpr TerOpEncoder terop_encoders[] = {
+#define PROCESS(NAME,KIND,A,B,C,D,E,F,G,H) \
+  &KIND::smt<Shape<A,B,C,D,E,F,G,H>>,
+#include "ir/intrinsics_terop.h"
+#undef PROCESS
+};
+
+constexpr TerOpEvaluator terop_evaluators[] = {
+#define PROCESS(NAME,KIND,A,B,C,D,E,F,G,H) \
+  &KIND::eval<Shape<A,B,C,D,E,F,G,H>>,
+#include "ir/intrinsics_terop.h"
+#undef PROCESS
+};
+
+constexpr QuadOpEncoder quadop_encoders[] = {
+#define PROCESS(NAME,KIND,A,B,C,D,E,F,G,H,I,J) \
+  &KIND::smt<Shape<A,B,C,D,E,F,G,H,I,J>>,
+#include "ir/intrinsics_quadop.h"
+#undef PROCESS
+};
+
+constexpr QuadOpEvaluator quadop_evaluators[] = {
+#define PROCESS(NAME,KIND,A,B,C,D,E,F,G,H,I,J) \
+  &KIND::eval<Shape<A,B,C,D,E,F,G,H,I,J>>,
+#include "ir/intrinsics_quadop.h"
+#undef PROCESS
+};
+
+constexpr unsigned binop_chunks[] = {
+#define PROCESS(NAME,KIND,A,B,C,D,E,F) KIND::chunk<Shape<A,B,C,D,E,F>>,
+#include "ir/intrinsics_binop.h"
+#undef PROCESS
+};
+
+constexpr unsigned terop_chunks[] = {
+#define PROCESS(NAME,KIND,A,B,C,D,E,F,G,H) \
+  KIND::chunk<Shape<A,B,C,D,E,F,G,H>>,
+#include "ir/intrinsics_terop.h"
+#undef PROCESS
+};
+
+constexpr unsigned quadop_chunks[] = {
+#define PROCESS(NAME,KIND,A,B,C,D,E,F,G,H,I,J) \
+  KIND::chunk<Shape<A,B,C,D,E,F,G,H,I,J>>,
+#include "ir/intrinsics_quadop.h"
+#undef PROCESS
+};
+
+static_assert(size(binop_encoders) == X86IntrinBinOp::numOfX86Intrinsics);
+static_assert(size(terop_encoders) == X86IntrinTerOp::numOfX86Intrinsics);
+static_assert(size(quadop_encoders) == X86IntrinQuadOp::numOfX86Intrinsics);
+
+}
+
+namespace IR {
+
+optional<X86ConstVector> X86ConstVector::get(const Type &ty,
+                                             const StateValue &val) {
+  vector<uint64_t> words;
+  if (!val.value.isUInt(words))
+    return {};
+
+  X86ConstVector v;
+  auto aty = ty.getAsAggregateType();
+  unsigned n = aty ? aty->numElementsConst() : 1;
+  v.is_vector = aty;
+  v.lane_bits = aty ? aty->getChild(0).bits() : ty.bits();
+
+  uint64_t np;
+  if (aty) {
+    if (!val.non_poison.isUInt(np))
+      return {};
+  } else if (val.non_poison.isTrue()) {
+    np = 1;
+  } else if (val.non_poison.isFalse()) {
+    np = 0;
+  } else {
+    return {};
+  }
+
+  // lane 0 is the most significant one
+  for (unsigned i = 0; i != n; ++i) {
+    unsigned pos = n - i - 1;
+    v.lanes.emplace_back(get_bits(words, pos * v.lane_bits, v.lane_bits));
+    v.non_poison.emplace_back((np >> pos) & 1);
+  }
+  return v;
+}
+
+StateValue X86ConstVector::toSMT() const {
+  if (!is_vector)
+    return { expr::mkUInt(lanes[0], lane_bits), expr(non_poison[0]) };
+
+  unsigned n = lanes.size();
+  assert(n <= 64);
+  vector<uint64_t> words(divide_up(n * lane_bits, 64), 0);
+  uint64_t np = 0;
+  for (unsigned i = 0; i != n; ++i) {
+    unsigned pos = n - i - 1;
+    set_bits(words, pos * lane_bits, lane_bits, lanes[i]);
+    np |= uint64_t(non_poison[i]) << pos;
+  }
+  return { expr::mkUInt(words, n * lane_bits), expr::mkUInt(np, n) };
+}
+
+
+StateValue x86_encode(X86IntrinBinOp::Op op, const StateValue &a,
+                      const StateValue &b) {
+  return binop_encoders[op](a, b);
+}
+
+StateValue x86_encode(X86IntrinTerOp::Op op, const StateValue &a,
+                      const StateValue &b, const StateValue &c) {
+  return terop_encoders[op](a, b, c);
+}
+
+StateValue x86_encode(X86IntrinQuadOp::Op op, const StateValue &a,
+                      const StateValue &b, const StateValue &c,
+                      const StateValue &d) {
+  return quadop_encoders[op](a, b, c, d);
+}
+
+unsigned x86_lane_chunk(X86IntrinBinOp::Op op) {
+  return binop_chunks[op];
+}
+
+unsigned x86_lane_chunk(X86IntrinTerOp::Op op) {
+  return terop_chunks[op];
+}
+
+unsigned x86_lane_chunk(X86IntrinQuadOp::Op op) {
+  return quadop_chunks[op];
+}
+
+X86ConstVector x86_eval(X86IntrinBinOp::Op op, const X86ConstVector &a,
+                        const X86ConstVector &b) {
+  return binop_evaluators[op](a, b);
+}
+
+X86ConstVector x86_eval(X86IntrinTerOp::Op op, const X86ConstVector &a,
+                        const X86ConstVector &b, const X86ConstVector &c) {
+  return terop_evaluators[op](a, b, c);
+}
+
+X86ConstVector x86_eval(X86IntrinQuadOp::Op op, const X86ConstVector &a,
+                        const X86ConstVector &b, const X86ConstVector &c,
+                        const X86ConstVector &d) {
+  return quadop_evaluators[op](a, b, c, d);
+}
+
+}
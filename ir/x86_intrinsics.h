@@ -0,0 +1,61 @@
+#pragma once
+
+// Copyright (c) 2018-present The Alive2 Authors.
+// Distributed under the MIT license that can be found in the LICENSE file.
+
+#include "ir/instr.h"
+#include "ir/state_value.h"
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace IR {
+
+class Type;
+
+// A vector (or scalar) value whose lanes and poison bits are all known
+// constants. Lane 0 comes first.
+struct X86ConstVector {
+  unsigned lane_bits = 0;
+  bool is_vector = true;
+  std::vector<uint64_t> lanes;
+  std::vector<bool> non_poison;
+
+  X86ConstVector() = default;
+  X86ConstVector(std::pair<unsigned, unsigned> shape)
+    : lane_bits(shape.second), is_vector(shape.first != 1) {}
+
+  static std::optional<X86ConstVector> get(const Type &ty,
+                                           const StateValue &val);
+  StateValue toSMT() const;
+};
+
+// Semantics of the x86 intrinsics. Each entry of intrinsics_binop.h,
+// intrinsics_terop.h and intrinsics_quadop.h (generated from
+// ir/x86_intrinsics.spec) names a kernel (its KIND column) that is
+// instantiated with the shapes of that entry. The kernel gives both the SMT
+// encoding and a native evaluator for constant operands.
+StateValue x86_encode(X86IntrinBinOp::Op op, const StateValue &a,
+                      const StateValue &b);
+StateValue x86_encode(X86IntrinTerOp::Op op, const StateValue &a,
+                      const StateValue &b, const StateValue &c);
+StateValue x86_encode(X86IntrinQuadOp::Op op, const StateValue &a,
+                      const StateValue &b, const StateValue &c,
+                      const StateValue &d);
+
+X86ConstVector x86_eval(X86IntrinBinOp::Op op, const X86ConstVector &a,
+                        const X86ConstVector &b);
+X86ConstVector x86_eval(X86IntrinTerOp::Op op, const X86ConstVector &a,
+                        const X86ConstVector &b, const X86ConstVector &c);
+X86ConstVector x86_eval(X86IntrinQuadOp::Op op, const X86ConstVector &a,
+                        const X86ConstVector &b, const X86ConstVector &c,
+                        const X86ConstVector &d);
+
+// Lane-dependency metadata: each chunk of this many bits of the result only
+// depends on the chunks at the same position of the vector operands, plus
+// any scalar or broadcast operand. 0 if there is no such chunk.
+unsigned x86_lane_chunk(X86IntrinBinOp::Op op);
+unsigned x86_lane_chunk(X86IntrinTerOp::Op op);
+unsigned x86_lane_chunk(X86IntrinQuadOp::Op op);
+
+}
@@ -0,0 +1,347 @@
+# Semantics of the x86 intrinsics supported by Alive2.
+#
+# scripts/gen-x86-intrinsics.py turns this file into the PROCESS tables
+# (ir/intrinsics_{binop,terop,quadop}.h) and into the element operations and
+# kernel aliases of ir/x86_intrinsics.cpp (ir/x86_intrinsics_gen.h). Both
+# are generated in the build directory as part of the build.
+#
+# There are three kinds of entries:
+#
+# op Name(a, b: <width>, ...) -> <width>
+#   let tmp = <expr>
+#   dst = <expr>
+#
+#   An element operation in the style of the pseudocode of the Intel
+#   intrinsics guide. The parameters and dst are lanes of W bits unless
+#   given another width; the width of the first parameter must use W. The
+#   generator emits a struct with both an SMT encoding and a native
+#   evaluator for constant folding, so the two cannot disagree.
+#
+#   Expressions are built from the parameters, earlier lets, integer
+#   literals (which take the width of the other operand) and:
+#     + - * & | ^ << >>             modular, >> is a logical shift
+#     == != <s <=s >s >=s <u <=u >u >=u
+#     c ? x : y
+#     x[hi:lo]                      bits hi down to lo
+#     ZeroExtend(x, n) SignExtend(x, n) Truncate(x, n)
+#     Saturate(x, n) SaturateU(x, n)  signed x clamped to n bits
+#     SAR(x, y) ABS(x)
+#   Widths (n, hi, lo) are integers and W combined with + - *.
+#   Intermediate values are limited to 64 bits so they can be evaluated
+#   natively; the generator checks this for every intrinsic using the op.
+#
+# kind name = Kernel<...>
+#
+#   A name for the KIND column: a kernel of ir/x86_intrinsics.cpp
+#   instantiated with element operations. Kernels with non element-wise
+#   data movement (shuffles, packs, horizontal ops) are written in C++.
+#
+# binop|terop|quadop <LLVM intrinsic> <kind> <ret shape> <operand shapes>
+#
+#   An intrinsic. Shapes are LANESxBITS; a single lane is a scalar. The
+#   table follows from the number of operands.
+
+
+op Lshr(a, n)
+  dst = a >> n
+
+op Ashr(a, n)
+  dst = SAR(a, n)
+
+op Shl(a, n)
+  dst = a << n
+
+op Add(a, b)
+  dst = a + b
+
+op Sub(a, b)
+  dst = a - b
+
+op AddSat(a, b)
+  dst = Saturate(SignExtend(a, W + 1) + SignExtend(b, W + 1), W)
+
+op SubSat(a, b)
+  dst = Saturate(SignExtend(a, W + 1) - SignExtend(b, W + 1), W)
+
+op NarrowSat(a: 2 * W)
+  dst = Saturate(a, W)
+
+op NarrowUSat(a: 2 * W)
+  dst = SaturateU(a, W)
+
+op MAddWD(a1, a2, b1, b2) -> 2 * W
+  let p1 = SignExtend(a1, 2 * W) * SignExtend(b1, 2 * W)
+  let p2 = SignExtend(a2, 2 * W) * SignExtend(b2, 2 * W)
+  dst = p1 + p2
+
+# unsigned a times signed b; the sum is exact in 2 * W + 1 bits
+op MAddUBSW(a1, a2, b1, b2) -> 2 * W
+  let p1 = ZeroExtend(a1, 2 * W + 1) * SignExtend(b1, 2 * W + 1)
+  let p2 = ZeroExtend(a2, 2 * W + 1) * SignExtend(b2, 2 * W + 1)
+  dst = Saturate(p1 + p2, 2 * W)
+
+op Avg(a, b)
+  dst = (ZeroExtend(a, W + 1) + ZeroExtend(b, W + 1) + 1)[W:1]
+
+op Sign(a, b)
+  dst = b == 0 ? 0 : b <s 0 ? 0 - a : a
+
+op MulHi(a, b)
+  dst = (SignExtend(a, 2 * W) * SignExtend(b, 2 * W))[2 * W - 1:W]
+
+op MulHiU(a, b)
+  dst = (ZeroExtend(a, 2 * W) * ZeroExtend(b, 2 * W))[2 * W - 1:W]
+
+op MulHiRS(a, b)
+  let tmp = ((SignExtend(a, 2 * W) * SignExtend(b, 2 * W)) >> 14) + 1
+  dst = tmp[W:1]
+
+
+kind psrl       = ShiftByVector<Lshr>
+kind psra       = ShiftByVector<Ashr>
+kind psll       = ShiftByVector<Shl>
+kind psrli      = ShiftByScalar<Lshr>
+kind psrai      = ShiftByScalar<Ashr>
+kind pslli      = ShiftByScalar<Shl>
+kind psrlv      = Vertical<Lshr>
+kind psrav      = Vertical<Ashr>
+kind psllv      = Vertical<Shl>
+kind pavg       = Vertical<Avg>
+kind psign      = Vertical<Sign>
+kind pmulh      = Vertical<MulHi>
+kind pmulhu     = Vertical<MulHiU>
+kind pmulhrsw   = Vertical<MulHiRS>
+kind phadd      = Horizontal<Add>
+kind phadds     = Horizontal<AddSat>
+kind phsub      = Horizontal<Sub>
+kind phsubs     = Horizontal<SubSat>
+kind packss     = Pack<NarrowSat>
+kind packus     = Pack<NarrowUSat>
+kind pmaddwd    = MultiplyAdd<MAddWD>
+kind pmaddubsw  = MultiplyAdd<MAddUBSW>
+kind psad       = SumAbsDiff
+kind pshufb     = ShuffleBytes
+kind pblendvb   = BlendBytes
+kind vpdpbusd   = Vertical3<DotProduct<4, false, false>>
+kind vpdpbusds  = Vertical3<DotProduct<4, false, true>>
+kind vpdpwssd   = Vertical3<DotProduct<2, true, false>>
+kind vpdpwssds  = Vertical3<DotProduct<2, true, true>>
+kind vpermi2var = Permute2
+kind vpmadd52l  = Vertical3<MAdd52<false>>
+kind vpmadd52h  = Vertical3<MAdd52<true>>
+kind pternlog   = TernaryLogic
+
+
+binop  x86_sse2_pavg_w                pavg       8x16  8x16  8x16
+binop  x86_sse2_pavg_b                pavg       16x8  16x8  16x8
+binop  x86_avx2_pavg_w                pavg       16x16 16x16 16x16
+binop  x86_avx2_pavg_b                pavg       32x8  32x8  32x8
+binop  x86_avx512_pavg_w_512          pavg       32x16 32x16 32x16
+binop  x86_avx512_pavg_b_512          pavg       64x8  64x8  64x8
+
+binop  x86_avx2_pshuf_b               pshufb     32x8  32x8  32x8
+binop  x86_ssse3_pshuf_b_128          pshufb     16x8  16x8  16x8
+binop  x86_avx512_pshuf_b_512         pshufb     64x8  64x8  64x8
+
+binop  x86_sse2_psrl_w                psrl       8x16  8x16  8x16
+binop  x86_sse2_psrl_d                psrl       4x32  4x32  4x32
+binop  x86_sse2_psrl_q                psrl       2x64  2x64  2x64
+binop  x86_avx2_psrl_w                psrl       16x16 16x16 8x16
+binop  x86_avx2_psrl_d                psrl       8x32  8x32  4x32
+binop  x86_avx2_psrl_q                psrl       4x64  4x64  2x64
+binop  x86_avx512_psrl_w_512          psrl       32x16 32x16 8x16
+binop  x86_avx512_psrl_d_512          psrl       16x32 16x32 4x32
+binop  x86_avx512_psrl_q_512          psrl       8x64  8x64  2x64
+
+binop  x86_sse2_psrli_w               psrli      8x16  8x16  1x32
+binop  x86_sse2_psrli_d               psrli      4x32  4x32  1x32
+binop  x86_sse2_psrli_q               psrli      2x64  2x64  1x32
+binop  x86_avx2_psrli_w               psrli      16x16 16x16 1x32
+binop  x86_avx2_psrli_d               psrli      8x32  8x32  1x32
+binop  x86_avx2_psrli_q               psrli      4x64  4x64  1x32
+binop  x86_avx512_psrli_w_512         psrli      32x16 32x16 1x32
+binop  x86_avx512_psrli_d_512         psrli      16x32 16x32 1x32
+binop  x86_avx512_psrli_q_512         psrli      8x64  8x64  1x32
+
+binop  x86_avx2_psrlv_d               psrlv      4x32  4x32  4x32
+binop  x86_avx2_psrlv_d_256           psrlv      8x32  8x32  8x32
+binop  x86_avx2_psrlv_q               psrlv      2x64  2x64  2x64
+binop  x86_avx2_psrlv_q_256           psrlv      4x64  4x64  4x64
+binop  x86_avx512_psrlv_d_512         psrlv      16x32 16x32 16x32
+binop  x86_avx512_psrlv_q_512         psrlv      8x64  8x64  8x64
+binop  x86_avx512_psrlv_w_128         psrlv      8x16  8x16  8x16
+binop  x86_avx512_psrlv_w_256         psrlv      16x16 16x16 16x16
+binop  x86_avx512_psrlv_w_512         psrlv      32x16 32x16 32x16
+
+binop  x86_sse2_psra_w                psra       8x16  8x16  8x16
+binop  x86_sse2_psra_d                psra       4x32  4x32  4x32
+binop  x86_avx2_psra_w                psra       16x16 16x16 8x16
+binop  x86_avx2_psra_d                psra       8x32  8x32  4x32
+binop  x86_avx512_psra_q_128          psra       2x64  2x64  2x64
+binop  x86_avx512_psra_q_256          psra       4x64  4x64  2x64
+binop  x86_avx512_psra_w_512          psra       32x16 32x16 8x16
+binop  x86_avx512_psra_d_512          psra       16x32 16x32 4x32
+binop  x86_avx512_psra_q_512          psra       8x64  8x64  2x64
+
+binop  x86_sse2_psrai_w               psrai      8x16  8x16  1x32
+binop  x86_sse2_psrai_d               psrai      4x32  4x32  1x32
+binop  x86_avx2_psrai_w               psrai      16x16 16x16 1x32
+binop  x86_avx2_psrai_d               psrai      8x32  8x32  1x32
+binop  x86_avx512_psrai_w_512         psrai      32x16 32x16 1x32
+binop  x86_avx512_psrai_d_512         psrai      16x32 16x32 1x32
+binop  x86_avx512_psrai_q_128         psrai      2x64  2x64  1x32
+binop  x86_avx512_psrai_q_256         psrai      4x64  4x64  1x32
+binop  x86_avx512_psrai_q_512         psrai      8x64  8x64  1x32
+
+binop  x86_avx2_psrav_d               psrav      4x32  4x32  4x32
+binop  x86_avx2_psrav_d_256           psrav      8x32  8x32  8x32
+binop  x86_avx512_psrav_d_512         psrav      16x32 16x32 16x32
+binop  x86_avx512_psrav_q_128         psrav      2x64  2x64  2x64
+binop  x86_avx512_psrav_q_256         psrav      4x64  4x64  4x64
+binop  x86_avx512_psrav_q_512         psrav      8x64  8x64  8x64
+binop  x86_avx512_psrav_w_128         psrav      8x16  8x16  8x16
+binop  x86_avx512_psrav_w_256         psrav      16x16 16x16 16x16
+binop  x86_avx512_psrav_w_512         psrav      32x16 32x16 32x16
+
+binop  x86_sse2_psll_w                psll       8x16  8x16  8x16
+binop  x86_sse2_psll_d                psll       4x32  4x32  4x32
+binop  x86_sse2_psll_q                psll       2x64  2x64  2x64
+binop  x86_avx2_psll_w                psll       16x16 16x16 8x16
+binop  x86_avx2_psll_d                psll       8x32  8x32  4x32
+binop  x86_avx2_psll_q                psll       4x64  4x64  2x64
+binop  x86_avx512_psll_w_512          psll       32x16 32x16 8x16
+binop  x86_avx512_psll_d_512          psll       16x32 16x32 4x32
+binop  x86_avx512_psll_q_512          psll       8x64  8x64  2x64
+
+binop  x86_sse2_pslli_w               pslli      8x16  8x16  1x32
+binop  x86_sse2_pslli_d               pslli      4x32  4x32  1x32
+binop  x86_sse2_pslli_q               pslli      2x64  2x64  1x32
+binop  x86_avx2_pslli_w               pslli      16x16 16x16 1x32
+binop  x86_avx2_pslli_d               pslli      8x32  8x32  1x32
+binop  x86_avx2_pslli_q               pslli      4x64  4x64  1x32
+binop  x86_avx512_pslli_w_512         pslli      32x16 32x16 1x32
+binop  x86_avx512_pslli_d_512         pslli      16x32 16x32 1x32
+binop  x86_avx512_pslli_q_512         pslli      8x64  8x64  1x32
+
+binop  x86_avx2_psllv_d               psllv      4x32  4x32  4x32
+binop  x86_avx2_psllv_d_256           psllv      8x32  8x32  8x32
+binop  x86_avx2_psllv_q               psllv      2x64  2x64  2x64
+binop  x86_avx2_psllv_q_256           psllv      4x64  4x64  4x64
+binop  x86_avx512_psllv_d_512         psllv      16x32 16x32 16x32
+binop  x86_avx512_psllv_q_512         psllv      8x64  8x64  8x64
+binop  x86_avx512_psllv_w_128         psllv      8x16  8x16  8x16
+binop  x86_avx512_psllv_w_256         psllv      16x16 16x16 16x16
+binop  x86_avx512_psllv_w_512         psllv      32x16 32x16 32x16
+
+binop  x86_ssse3_psign_b_128          psign      16x8  16x8  16x8
+binop  x86_ssse3_psign_w_128          psign      8x16  8x16  8x16
+binop  x86_ssse3_psign_d_128          psign      4x32  4x32  4x32
+binop  x86_avx2_psign_b               psign      32x8  32x8  32x8
+binop  x86_avx2_psign_w               psign      16x16 16x16 16x16
+binop  x86_avx2_psign_d               psign      8x32  8x32  8x32
+
+binop  x86_ssse3_phadd_w_128          phadd      8x16  8x16  8x16
+binop  x86_ssse3_phadd_d_128          phadd      4x32  4x32  4x32
+
+binop  x86_ssse3_phadd_sw_128         phadds     8x16  8x16  8x16
+
+binop  x86_avx2_phadd_w               phadd      16x16 16x16 16x16
+binop  x86_avx2_phadd_d               phadd      8x32  8x32  8x32
+
+binop  x86_avx2_phadd_sw              phadds     16x16 16x16 16x16
+
+binop  x86_ssse3_phsub_w_128          phsub      8x16  8x16  8x16
+binop  x86_ssse3_phsub_d_128          phsub      4x32  4x32  4x32
+
+binop  x86_ssse3_phsub_sw_128         phsubs     8x16  8x16  8x16
+
+binop  x86_avx2_phsub_w               phsub      16x16 16x16 16x16
+binop  x86_avx2_phsub_d               phsub      8x32  8x32  8x32
+
+binop  x86_avx2_phsub_sw              phsubs     16x16 16x16 16x16
+
+binop  x86_sse2_pmulh_w               pmulh      8x16  8x16  8x16
+binop  x86_avx2_pmulh_w               pmulh      16x16 16x16 16x16
+binop  x86_avx512_pmulh_w_512         pmulh      32x16 32x16 32x16
+
+binop  x86_sse2_pmulhu_w              pmulhu     8x16  8x16  8x16
+binop  x86_avx2_pmulhu_w              pmulhu     16x16 16x16 16x16
+binop  x86_avx512_pmulhu_w_512        pmulhu     32x16 32x16 32x16
+
+binop  x86_ssse3_pmul_hr_sw_128       pmulhrsw   8x16  8x16  8x16
+binop  x86_avx2_pmul_hr_sw            pmulhrsw   16x16 16x16 16x16
+binop  x86_avx512_pmul_hr_sw_512      pmulhrsw   32x16 32x16 32x16
+
+binop  x86_sse2_pmadd_wd              pmaddwd    4x32  8x16  8x16
+binop  x86_avx2_pmadd_wd              pmaddwd    8x32  16x16 16x16
+binop  x86_avx512_pmaddw_d_512        pmaddwd    16x32 32x16 32x16
+
+binop  x86_ssse3_pmadd_ub_sw_128      pmaddubsw  8x16  16x8  16x8
+binop  x86_avx2_pmadd_ub_sw           pmaddubsw  16x16 32x8  32x8
+binop  x86_avx512_pmaddubs_w_512      pmaddubsw  32x16 64x8  64x8
+
+binop  x86_sse2_packsswb_128          packss     16x8  8x16  8x16
+binop  x86_avx2_packsswb              packss     32x8  16x16 16x16
+binop  x86_avx512_packsswb_512        packss     64x8  32x16 32x16
+
+binop  x86_sse2_packuswb_128          packus     16x8  8x16  8x16
+binop  x86_avx2_packuswb              packus     32x8  16x16 16x16
+binop  x86_avx512_packuswb_512        packus     64x8  32x16 32x16
+
+binop  x86_sse2_packssdw_128          packss     8x16  4x32  4x32
+binop  x86_avx2_packssdw              packss     16x16 8x32  8x32
+binop  x86_avx512_packssdw_512        packss     32x16 16x32 16x32
+
+binop  x86_sse41_packusdw             packus     8x16  4x32  4x32
+binop  x86_avx2_packusdw              packus     16x16 8x32  8x32
+binop  x86_avx512_packusdw_512        packus     32x16 16x32 16x32
+
+binop  x86_sse2_psad_bw               psad       2x64  16x8  16x8
+binop  x86_avx2_psad_bw               psad       4x64  32x8  32x8
+binop  x86_avx512_psad_bw_512         psad       8x64  64x8  64x8
+
+terop  x86_avx2_pblendvb              pblendvb   32x8  32x8  32x8  32x8
+
+terop  x86_avx512_vpdpbusd_128        vpdpbusd   4x32  4x32  4x32  4x32
+terop  x86_avx512_vpdpbusd_256        vpdpbusd   8x32  8x32  8x32  8x32
+terop  x86_avx512_vpdpbusd_512        vpdpbusd   16x32 16x32 16x32 16x32
+
+terop  x86_avx512_vpdpbusds_128       vpdpbusds  4x32  4x32  4x32  4x32
+terop  x86_avx512_vpdpbusds_256       vpdpbusds  8x32  8x32  8x32  8x32
+terop  x86_avx512_vpdpbusds_512       vpdpbusds  16x32 16x32 16x32 16x32
+
+terop  x86_avx512_vpdpwssd_128        vpdpwssd   4x32  4x32  4x32  4x32
+terop  x86_avx512_vpdpwssd_256        vpdpwssd   8x32  8x32  8x32  8x32
+terop  x86_avx512_vpdpwssd_512        vpdpwssd   16x32 16x32 16x32 16x32
+
+terop  x86_avx512_vpdpwssds_128       vpdpwssds  4x32  4x32  4x32  4x32
+terop  x86_avx512_vpdpwssds_256       vpdpwssds  8x32  8x32  8x32  8x32
+terop  x86_avx512_vpdpwssds_512       vpdpwssds  16x32 16x32 16x32 16x32
+
+terop  x86_avx512_vpermi2var_d_128    vpermi2var 4x32  4x32  4x32  4x32
+terop  x86_avx512_vpermi2var_d_256    vpermi2var 8x32  8x32  8x32  8x32
+terop  x86_avx512_vpermi2var_d_512    vpermi2var 16x32 16x32 16x32 16x32
+terop  x86_avx512_vpermi2var_q_128    vpermi2var 2x64  2x64  2x64  2x64
+terop  x86_avx512_vpermi2var_q_256    vpermi2var 4x64  4x64  4x64  4x64
+terop  x86_avx512_vpermi2var_q_512    vpermi2var 8x64  8x64  8x64  8x64
+terop  x86_avx512_vpermi2var_hi_128   vpermi2var 8x16  8x16  8x16  8x16
+terop  x86_avx512_vpermi2var_hi_256   vpermi2var 16x16 16x16 16x16 16x16
+terop  x86_avx512_vpermi2var_hi_512   vpermi2var 32x16 32x16 32x16 32x16
+terop  x86_avx512_vpermi2var_qi_128   vpermi2var 16x8  16x8  16x8  16x8
+terop  x86_avx512_vpermi2var_qi_256   vpermi2var 32x8  32x8  32x8  32x8
+terop  x86_avx512_vpermi2var_qi_512   vpermi2var 64x8  64x8  64x8  64x8
+
+terop  x86_avx512_vpmadd52l_uq_128    vpmadd52l  2x64  2x64  2x64  2x64
+terop  x86_avx512_vpmadd52l_uq_256    vpmadd52l  4x64  4x64  4x64  4x64
+terop  x86_avx512_vpmadd52l_uq_512    vpmadd52l  8x64  8x64  8x64  8x64
+
+terop  x86_avx512_vpmadd52h_uq_128    vpmadd52h  2x64  2x64  2x64  2x64
+terop  x86_avx512_vpmadd52h_uq_256    vpmadd52h  4x64  4x64  4x64  4x64
+terop  x86_avx512_vpmadd52h_uq_512    vpmadd52h  8x64  8x64  8x64  8x64
+
+quadop x86_avx512_pternlog_d_128      pternlog   4x32  4x32  4x32  4x32  1x32
+quadop x86_avx512_pternlog_d_256      pternlog   8x32  8x32  8x32  8x32  1x32
+quadop x86_avx512_pternlog_d_512      pternlog   16x32 16x32 16x32 16x32 1x32
+quadop x86_avx512_pternlog_q_128      pternlog   2x64  2x64  2x64  2x64  1x32
+quadop x86_avx512_pternlog_q_256      pternlog   4x64  4x64  4x64  4x64  1x32
+quadop x86_avx512_pternlog_q_512      pternlog   8x64  8x64  8x64  8x64  1x32
@@ -20,9 +20,18 @@ config::skip_smt = opt_smt_skip;
 config::smt_benchmark_dir = opt_smt_bench_dir;
 smt::solver_print_queries(opt_smt_verbose);
 smt::solver_tactic_verbose(opt_tactic_verbose);
+smt::solver_portfolio(opt_smt_portfolio);
+if (!smt::solver_backend(opt_smt_backend)) {
+  cerr << "SMT backend " << opt_smt_backend << " not compiled in!\n";
+  exit(1);
+}
+smt::solver_query_cache(opt_smt_query_cache, opt_smt_query_cache_dir);
 config::debug = opt_debug;
 config::max_offset_bits = opt_max_offset_in_bits;
 config::max_sizet_bits  = opt_max_sizet_in_bits;
+config::narrow_ptr_bits = opt_narrow_ptr_bits;
+config::x86_shuffle_mux = opt_x86_shuffle_mux;
+config::split_vector_lanes = opt_split_vector_lanes;
 
 if ((config::disallow_ub_exploitation = opt_disallow_ub_exploitation)) {
   config::disable_undef_input = true;
@@ -87,11 +96,21 @@ if (!opt_outputfile.empty()) {
 util::config::set_debug(*out);
 
 
-if (opt_cache) {
+// the plugin may be initialized several times in the same process; keep the
+// cache (and its connection) around
+if (opt_cache && !cache) {
+  if (opt_cache_redis) {
 #ifdef NO_REDIS_SUPPORT
-  cerr << "REDIS support not compiled in!\n";
-  exit(1);
+    cerr << "REDIS support not compiled in!\n";
+    exit(1);
 #else
-  cache = make_unique<Cache>(opt_cache_port, opt_cache_allow_version_mismatch);
+    cache = make_unique<RedisCache>(opt_cache_port,
+                                    opt_cache_allow_version_mismatch);
 #endif
+  } else {
+    cache = make_unique<DiskCache>(opt_cache_file.empty()
+                                     ? DiskCache::defaultPath()
+                                     : opt_cache_file.getValue(),
+                                   opt_cache_allow_version_mismatch);
+  }
 }
@@ -75,6 +75,27 @@ llvm::cl::opt<unsigned> opt_smt_random_seed(LLVM_ARGS_PREFIX "smt-random-seed",
   llvm::cl::desc("Random seed for the SMT solver (default=0)"),
   llvm::cl::init(0), llvm::cl::cat(alive_cmdargs));
 
+llvm::cl::opt<unsigned> opt_smt_portfolio(LLVM_ARGS_PREFIX "smt-portfolio",
+  llvm::cl::desc("Run each SMT query with this many solver configurations in "
+                 "parallel and take the first answer (default=off)"),
+  llvm::cl::init(0), llvm::cl::cat(alive_cmdargs));
+
+llvm::cl::opt<string> opt_smt_backend(LLVM_ARGS_PREFIX "smt-backend",
+  llvm::cl::desc("SMT solver for the queries in its logic, e.g., bitwuzla for "
+                 "QF_BV; Z3 answers the others (default=z3)"),
+  llvm::cl::init("z3"), llvm::cl::cat(alive_cmdargs));
+
+llvm::cl::opt<bool> opt_smt_query_cache(LLVM_ARGS_PREFIX "smt-query-cache",
+  llvm::cl::desc("Memoize the answers of SMT queries, so repeated queries are "
+                 "not sent to the solver (default=off)"),
+  llvm::cl::init(false), llvm::cl::cat(alive_cmdargs));
+
+llvm::cl::opt<string> opt_smt_query_cache_dir(
+  LLVM_ARGS_PREFIX "smt-query-cache-dir",
+  llvm::cl::desc("Also store the answers of SMT queries in this directory, so "
+                 "they are shared across runs (implies -smt-query-cache)"),
+  llvm::cl::value_desc("directory"), llvm::cl::cat(alive_cmdargs));
+
 llvm::cl::opt<bool> opt_smt_log(LLVM_ARGS_PREFIX "smt-log",
   llvm::cl::desc("Log interactions with the SMT solver"),
   llvm::cl::init(false), llvm::cl::cat(alive_cmdargs));
@@ -151,7 +172,17 @@ llvm::cl::opt<bool> opt_overwrite_reports(LLVM_ARGS_PREFIX "overwrite-reports",
 
 llvm::cl::opt<bool> opt_cache(LLVM_ARGS_PREFIX "cache",
   llvm::cl::init(false),
-  llvm::cl::desc("Use external cache (default=false)"));
+  llvm::cl::desc("Cache verification results (default=false)"));
+
+llvm::cl::opt<string> opt_cache_file(LLVM_ARGS_PREFIX "cache-file",
+  llvm::cl::desc("File that holds the cache (default: "
+                 "$XDG_CACHE_HOME/alive2/results)"),
+  llvm::cl::value_desc("filename"));
+
+llvm::cl::opt<bool> opt_cache_redis(LLVM_ARGS_PREFIX "cache-redis",
+  llvm::cl::init(false),
+  llvm::cl::desc("Keep the cache in a Redis server instead of a local file "
+                 "(default=false)"));
 
 llvm::cl::opt<bool> opt_assume_cache_hit(LLVM_ARGS_PREFIX "assume-cache-hit",
   llvm::cl::init(false),
@@ -163,7 +194,7 @@ llvm::cl::opt<unsigned> opt_cache_port(LLVM_ARGS_PREFIX "cache-port",
 
 llvm::cl::opt<bool> opt_cache_allow_version_mismatch(LLVM_ARGS_PREFIX
   "cache-allow-version-mismatch", llvm::cl::init(false),
-  llvm::cl::desc("Allow external cache to have been created by a different "
+  llvm::cl::desc("Allow the cache to have been created by a different "
                  "version of Alive2 (default=false"));
 
 llvm::cl::opt<unsigned> opt_max_offset_in_bits(
@@ -180,6 +211,26 @@ llvm::cl::opt<unsigned> opt_max_sizet_in_bits(
                  "address space size exceeds the specified limit."),
   llvm::cl::cat(alive_cmdargs));
 
+llvm::cl::opt<unsigned> opt_narrow_ptr_bits(
+  LLVM_ARGS_PREFIX "narrow-ptr-bits", llvm::cl::init(0),
+  llvm::cl::desc("Verify first with pointer offsets and sizes of at most "
+                 "this many bits, and replay bugs found at full width "
+                 "(default=0, i.e., disabled)"),
+  llvm::cl::cat(alive_cmdargs));
+
+llvm::cl::opt<bool> opt_x86_shuffle_mux(
+  LLVM_ARGS_PREFIX "x86-shuffle-mux",
+  llvm::cl::desc("Encode x86 variable shuffles with a mux tree over the "
+                 "candidate elements (default=false)"),
+  llvm::cl::init(false), llvm::cl::cat(alive_cmdargs));
+
+llvm::cl::opt<unsigned> opt_split_vector_lanes(
+  LLVM_ARGS_PREFIX "split-vector-lanes",
+  llvm::cl::desc("Check lane-separable vector results with one query per "
+                 "chunk of lanes, running up to this many queries in "
+                 "parallel (default=0, i.e., disabled)"),
+  llvm::cl::init(0), llvm::cl::cat(alive_cmdargs));
+
 llvm::cl::opt<bool> opt_disallow_ub_exploitation(
   LLVM_ARGS_PREFIX "disallow-ub-exploitation",
   llvm::cl::desc("Disallow UB exploitation by optimizations (default=allow)"),
@@ -7,6 +7,7 @@
 #include "smt/smt.h"
 #include "tools/transform.h"
 
+#include <climits>
 #include <sstream>
 #include <utility>
 
@@ -40,8 +41,8 @@ struct Results {
 
 Results verify(llvm::Function &F1, llvm::Function &F2,
                llvm::TargetLibraryInfoWrapperPass &TLI,
-               smt::smt_initializer &smt_init, ostream &out,
-               bool print_transform, bool always_verify) {
+               Verifier &v, ostream &out, bool print_transform,
+               bool always_verify) {
   auto fn1 = llvm2alive(F1, TLI.getTLI(F1), true);
   if (!fn1)
     return Results::Error("Could not translate '" + F1.getName().str() +
@@ -68,7 +69,7 @@ Results verify(llvm::Function &F1, llvm::Function &F2,
     }
   }
 
-  smt_init.reset();
+  v.prepareContext();
   r.t.preprocess();
   TransformVerify verifier(r.t, false);
 
@@ -95,8 +96,21 @@ Results verify(llvm::Function &F1, llvm::Function &F2,
 
 } // namespace
 
+void Verifier::prepareContext() {
+  // Tearing down the context also drops the tactic pipeline and every term
+  // created so far, which dominates the cost of small queries. In batch mode
+  // keep it alive until the batch is over or it starts using a fair share of
+  // the memory budget, since the limit is global and not per query.
+  if (batch_left > 0 && !smt::hit_quarter_memory_limit()) {
+    --batch_left;
+    return;
+  }
+  smt_init.reset();
+  batch_left = batch_size == 0 ? UINT_MAX : batch_size - 1;
+}
+
 bool Verifier::compareFunctions(llvm::Function &F1, llvm::Function &F2) {
-  auto r = verify(F1, F2, TLI, smt_init, out, !quiet, always_verify);
+  auto r = verify(F1, F2, TLI, *this, out, !quiet, always_verify);
   if (r.status == Results::ERROR) {
     out << "ERROR: " << r.error;
     ++num_errors;
@@ -143,7 +157,7 @@ bool Verifier::compareFunctions(llvm::Function &F1, llvm::Function &F2) {
   }
 
   if (bidirectional) {
-    r = verify(F2, F1, TLI, smt_init, out, false, always_verify);
+    r = verify(F2, F1, TLI, *this, out, false, always_verify);
     switch (r.status) {
     case Results::ERROR:
     case Results::TYPE_CHECKER_FAILED:
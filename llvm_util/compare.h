@@ -22,12 +22,17 @@ struct Verifier {
   bool always_verify = false;
   bool print_dot = false;
   bool bidirectional = false;
+  // Number of verifications that share an SMT context before it is reset.
+  // 1 resets it for every query; 0 only resets it under memory pressure.
+  unsigned batch_size = 1;
+  unsigned batch_left = 0;
 
   Verifier(llvm::TargetLibraryInfoWrapperPass &TLI,
            smt::smt_initializer &smt_init, std::ostream &out)
     : TLI(TLI), smt_init(smt_init), out(out) {}
 
   bool compareFunctions(llvm::Function &F1, llvm::Function &F2);
+  void prepareContext();
 };
 
 }
@@ -91,6 +91,15 @@ string_view s(llvm::StringRef str) {
   if (!ty || !a || !b || !c)              \
     return error(i)
 
+#define PARSE_QUADOP()                    \
+  auto ty = llvm_type2alive(i.getType()); \
+  auto a = get_operand(i.getOperand(0));  \
+  auto b = get_operand(i.getOperand(1));  \
+  auto c = get_operand(i.getOperand(2));  \
+  auto d = get_operand(i.getOperand(3));  \
+  if (!ty || !a || !b || !c || !d)        \
+    return error(i)
+
 #define RETURN_IDENTIFIER(op)      \
   do {                             \
     auto ret = op;                 \
@@ -1165,14 +1174,14 @@ public:
       return NOP(i);
 
     // intel x86 intrinsics
-#define PROCESS(NAME,A,B,C,D,E,F) case llvm::Intrinsic::NAME:
+#define PROCESS(NAME,KIND,A,B,C,D,E,F) case llvm::Intrinsic::NAME:
 #include "ir/intrinsics_binop.h"
 #undef PROCESS
     {
       PARSE_BINOP();
       X86IntrinBinOp::Op op;
       switch (i.getIntrinsicID()) {
-#define PROCESS(NAME,A,B,C,D,E,F) \
+#define PROCESS(NAME,KIND,A,B,C,D,E,F) \
       case llvm::Intrinsic::NAME: \
         op = X86IntrinBinOp::NAME; break;
 #include "ir/intrinsics_binop.h"
@@ -1183,14 +1192,14 @@ public:
                                                     *a, *b, op));
     }
 
-#define PROCESS(NAME,A,B,C,D,E,F,G,H) case llvm::Intrinsic::NAME:
+#define PROCESS(NAME,KIND,A,B,C,D,E,F,G,H) case llvm::Intrinsic::NAME:
 #include "ir/intrinsics_terop.h"
 #undef PROCESS
     {
       PARSE_TRIOP();
       X86IntrinTerOp::Op op;
       switch (i.getIntrinsicID()) {
-#define PROCESS(NAME,A,B,C,D,E,F,G,H) \
+#define PROCESS(NAME,KIND,A,B,C,D,E,F,G,H) \
       case llvm::Intrinsic::NAME: \
         op = X86IntrinTerOp::NAME; break;
 #include "ir/intrinsics_terop.h"
@@ -1201,6 +1210,24 @@ public:
                                                     *a, *b, *c, op));
     }
 
+#define PROCESS(NAME,KIND,A,B,C,D,E,F,G,H,I,J) case llvm::Intrinsic::NAME:
+#include "ir/intrinsics_quadop.h"
+#undef PROCESS
+    {
+      PARSE_QUADOP();
+      X86IntrinQuadOp::Op op;
+      switch (i.getIntrinsicID()) {
+#define PROCESS(NAME,KIND,A,B,C,D,E,F,G,H,I,J) \
+      case llvm::Intrinsic::NAME: \
+        op = X86IntrinQuadOp::NAME; break;
+#include "ir/intrinsics_quadop.h"
+#undef PROCESS
+      default: UNREACHABLE();
+      }
+      RETURN_IDENTIFIER(make_unique<X86IntrinQuadOp>(*ty, value_name(i),
+                                                     *a, *b, *c, *d, op));
+    }
+
     default:
       break;
     }
@@ -0,0 +1,643 @@
+#!/usr/bin/env python3
+# Copyright (c) 2018-present The Alive2 Authors.
+# Distributed under the MIT license that can be found in the LICENSE file.
+
+# Generates the x86 intrinsics tables and the element operations of
+# ir/x86_intrinsics.cpp from ir/x86_intrinsics.spec. See that file for the
+# format.
+#
+# usage: gen-x86-intrinsics.py <spec> <output dir>
+#
+# Writes <output dir>/ir/intrinsics_{binop,terop,quadop}.h and
+# <output dir>/ir/x86_intrinsics_gen.h.
+
+import os
+import re
+import sys
+
+ARITY = {'binop': 2, 'terop': 3, 'quadop': 4}
+TABLE = {'binop': 'intrinsics_binop.h', 'terop': 'intrinsics_terop.h',
+         'quadop': 'intrinsics_quadop.h'}
+
+
+class SpecError(Exception):
+  pass
+
+
+# Widths are linear in W, the width of the lanes: (coef, const).
+class Width:
+  def __init__(self, coef, const):
+    self.coef, self.const = coef, const
+
+  def __add__(self, o):
+    return Width(self.coef + o.coef, self.const + o.const)
+
+  def __sub__(self, o):
+    return Width(self.coef - o.coef, self.const - o.const)
+
+  def __eq__(self, o):
+    return self.coef == o.coef and self.const == o.const
+
+  def mul(self, o):
+    if self.coef and o.coef:
+      raise SpecError('width is not linear in W')
+    return Width(self.coef * o.const + o.coef * self.const,
+                 self.const * o.const)
+
+  def at(self, w):
+    return self.coef * w + self.const
+
+  def cpp(self):
+    if self.coef == 0:
+      return str(self.const)
+    s = 'W' if self.coef == 1 else '%d * W' % self.coef
+    if self.const > 0:
+      s += ' + %d' % self.const
+    elif self.const < 0:
+      s += ' - %d' % -self.const
+    return s
+
+
+# wraps s in parentheses unless it is a name, a number or a call
+def paren(s):
+  depth = 0
+  for c in s:
+    if c in '([':
+      depth += 1
+    elif c in ')]':
+      depth -= 1
+    elif depth == 0 and not (c.isalnum() or c in '_.:'):
+      return '(%s)' % s
+  return s
+
+
+# Expression nodes. Each has a width (None for booleans) and emits itself
+# both as an smt::expr and as a uint64_t truncated to its width.
+class Node:
+  def nodes(self):
+    yield self
+    for k in self.kids:
+      yield from k.nodes()
+
+  # checks the node for lanes of w bits
+  def check(self, w):
+    if self.width is not None and not 0 < self.width.at(w) <= 64:
+      raise SpecError('intermediate width %d for W=%d; the native evaluator '
+                      'only handles up to 64 bits' % (self.width.at(w), w))
+
+
+class Var(Node):
+  def __init__(self, name, width):
+    self.name, self.width, self.kids = name, width, []
+
+  def smt(self):
+    return self.name
+
+  def eval(self):
+    return self.name
+
+
+class Lit(Node):
+  def __init__(self, val):
+    self.val, self.width, self.kids = val, None, []
+
+  def smt(self):
+    if self.val < 0:
+      return 'expr::mkInt(%d, %s)' % (self.val, self.width.cpp())
+    return 'expr::mkUInt(%d, %s)' % (self.val, self.width.cpp())
+
+  def eval(self):
+    if 0 <= self.val < 256 and self.width.at(8) >= 8:
+      return str(self.val)
+    return 'trunc(uint64_t(%d), %s)' % (self.val, self.width.cpp())
+
+
+BINOPS = {
+  '+':  ('{0} + {1}',     'trunc({0} + {1}, {w})'),
+  '-':  ('{0} - {1}',     'trunc({0} - {1}, {w})'),
+  '*':  ('{0} * {1}',     'trunc({0} * {1}, {w})'),
+  '&':  ('{0} & {1}',     '{0} & {1}'),
+  '|':  ('{0} | {1}',     '{0} | {1}'),
+  '^':  ('{0} ^ {1}',     '{0} ^ {1}'),
+  '<<': ('{0} << {1}',    '{1} >= {w} ? 0 : trunc({0} << {1}, {w})'),
+  '>>': ('{p0}.lshr({1})', '{1} >= {w} ? 0 : {0} >> {1}'),
+}
+# shifts by a literal that is known to be in range
+CONST_SHIFTS = {
+  '<<': ('{0} << {1}',    'trunc({0} << {1}, {w})'),
+  '>>': ('{p0}.lshr({1})', '{0} >> {1}'),
+}
+CMPS = {
+  '==':  ('{0} == {1}',       '{0} == {1}'),
+  '!=':  ('{0} != {1}',       '{0} != {1}'),
+  '<s':  ('{p0}.slt({1})', 'sext({0}, {w}) < sext({1}, {w})'),
+  '<=s': ('{p0}.sle({1})', 'sext({0}, {w}) <= sext({1}, {w})'),
+  '>s':  ('{p0}.sgt({1})', 'sext({0}, {w}) > sext({1}, {w})'),
+  '>=s': ('{p0}.sge({1})', 'sext({0}, {w}) >= sext({1}, {w})'),
+  '<u':  ('{p0}.ult({1})', '{0} < {1}'),
+  '<=u': ('{p0}.ule({1})', '{0} <= {1}'),
+  '>u':  ('{p0}.ugt({1})', '{0} > {1}'),
+  '>=u': ('{p0}.uge({1})', '{0} >= {1}'),
+}
+
+
+def fit(l, r):
+  # literals take the width of the other operand
+  if l.width is None and isinstance(l, Lit):
+    l.width = r.width
+  if r.width is None and isinstance(r, Lit):
+    r.width = l.width
+  if l.width is None or r.width is None:
+    raise SpecError('operand width is unknown')
+  if not l.width == r.width:
+    raise SpecError('operands have widths %s and %s' %
+                    (l.width.cpp(), r.width.cpp()))
+
+
+class Bin(Node):
+  def __init__(self, op, l, r):
+    fit(l, r)
+    self.op, self.kids = op, [l, r]
+    self.width = None if op in CMPS else l.width
+
+  def const_shift(self):
+    return self.op in CONST_SHIFTS and isinstance(self.kids[1], Lit)
+
+  def check(self, w):
+    super().check(w)
+    if self.const_shift() and not 0 <= self.kids[1].val < self.width.at(w):
+      raise SpecError('shift by %d of a %d-bit value' %
+                      (self.kids[1].val, self.width.at(w)))
+
+  def fmt(self, i, k):
+    a, b = self.kids
+    tbl = CMPS if self.op in CMPS else \
+          CONST_SHIFTS if self.const_shift() else BINOPS
+    x = getattr(a, k)()
+    y = getattr(b, k)()
+    return tbl[self.op][i].format(paren(x), paren(y), p0=paren(x),
+                                  w=a.width.cpp())
+
+  def smt(self):
+    return self.fmt(0, 'smt')
+
+  def eval(self):
+    return self.fmt(1, 'eval')
+
+
+class Select(Node):
+  def __init__(self, c, t, f):
+    if c.width is not None:
+      raise SpecError('condition is not a comparison')
+    fit(t, f)
+    self.kids, self.width = [c, t, f], t.width
+
+  def smt(self):
+    c, t, f = (k.smt() for k in self.kids)
+    return 'expr::mkIf(%s, %s, %s)' % (c, t, f)
+
+  def eval(self):
+    c, t, f = (paren(k.eval()) for k in self.kids)
+    return '%s ? %s : %s' % (c, t, f)
+
+
+class Slice(Node):
+  def __init__(self, x, hi, lo):
+    if x.width is None:
+      raise SpecError('cannot slice a literal or comparison')
+    self.kids, self.hi, self.lo = [x], hi, lo
+    self.width = hi - lo + Width(0, 1)
+
+  def smt(self):
+    return '%s.extract(%s, %s)' % (paren(self.kids[0].smt()), self.hi.cpp(),
+                                   self.lo.cpp())
+
+  def eval(self):
+    x = paren(self.kids[0].eval())
+    if self.lo == Width(0, 0):
+      return 'trunc(%s, %s)' % (x, self.width.cpp())
+    return 'trunc(%s >> %s, %s)' % (x, paren(self.lo.cpp()), self.width.cpp())
+
+
+# name: (# of expression args, takes a width, smt, eval)
+FUNCS = {
+  'ZeroExtend': (1, True, '{p0}.zext({ext})', '{0}'),
+  'SignExtend': (1, True, '{p0}.sext({ext})',
+                 'trunc(sext({0}, {w0}), {n})'),
+  'Truncate':   (1, True, '{p0}.trunc({n})', 'trunc({0}, {n})'),
+  'Saturate':   (1, True,
+                 'expr::mkIf({p0}.sgt(expr::IntSMax({n}).sext({shrink})), '
+                 'expr::IntSMax({n}), expr::mkIf({p0}.slt(expr::IntSMin({n})'
+                 '.sext({shrink})), expr::IntSMin({n}), {p0}.trunc({n})))',
+                 'saturate(sext({0}, {w0}), smin({n}), smax({n}), {n})'),
+  'SaturateU':  (1, True,
+                 'expr::mkIf({p0}.sgt(expr::IntUMax({n}).zext({shrink})), '
+                 'expr::IntUMax({n}), expr::mkIf({p0}.isNegative(), '
+                 'expr::mkUInt(0, {n}), {p0}.trunc({n})))',
+                 'saturate(sext({0}, {w0}), 0, umax({n}), {n})'),
+  'ABS':        (1, False, '{p0}.abs()',
+                 'trunc(sext({0}, {w0}) < 0 ? -{0} : {0}, {w0})'),
+  'SAR':        (2, False, '{p0}.ashr({1})',
+                 'trunc(sext({0}, {w0}) >> min({1}, uint64_t({w0}) - 1), {w0})'),
+}
+
+
+class Call(Node):
+  def __init__(self, fn, args, n):
+    nargs, _, _, _ = FUNCS[fn]
+    if len(args) != nargs:
+      raise SpecError('%s takes %d arguments' % (fn, nargs))
+    if args[0].width is None:
+      raise SpecError('%s of a literal or comparison' % fn)
+    if nargs == 2:
+      fit(args[0], args[1])
+    self.fn, self.kids, self.n = fn, args, n
+    self.width = n if n is not None else args[0].width
+
+  def check(self, w):
+    super().check(w)
+    grow = self.width.at(w) - self.kids[0].width.at(w)
+    if self.fn in ('ZeroExtend', 'SignExtend') and grow < 0 or \
+       self.fn not in ('ZeroExtend', 'SignExtend') and grow > 0:
+      raise SpecError('%s from %d to %d bits' %
+                      (self.fn, self.kids[0].width.at(w), self.width.at(w)))
+
+  def fmt(self, i, k):
+    xs = [getattr(a, k)() for a in self.kids]
+    w0 = self.kids[0].width
+    d = {'p0': paren(xs[0]), 'w0': w0.cpp()}
+    if self.n is not None:
+      d['n'] = self.n.cpp()
+      d['ext'] = (self.n - w0).cpp()
+      d['shrink'] = (w0 - self.n).cpp()
+    return FUNCS[self.fn][i].format(*xs, **d)
+
+  def smt(self):
+    return self.fmt(2, 'smt')
+
+  def eval(self):
+    return self.fmt(3, 'eval')
+
+
+TOKEN = re.compile(r'\s*(?:(\d+)|(\w+)|(<=s|>=s|<=u|>=u|<s|>s|<u|>u|<<|>>|'
+                   r'==|!=|[-+*&|^?:()\[\],=]))')
+
+
+def tokenize(s):
+  toks, pos = [], 0
+  s = s.rstrip()
+  while pos < len(s):
+    m = TOKEN.match(s, pos)
+    if not m:
+      raise SpecError('unexpected character: %s' % s[pos:].strip())
+    pos = m.end()
+    if m.group(1):
+      toks.append(('num', int(m.group(1))))
+    elif m.group(2):
+      toks.append(('id', m.group(2)))
+    else:
+      toks.append(('op', m.group(3)))
+  return toks
+
+
+class Parser:
+  LEVELS = [list(CMPS), ['|'], ['^'], ['&'], ['<<', '>>'], ['+', '-'], ['*']]
+
+  def __init__(self, toks, env):
+    self.toks, self.pos, self.env = toks, 0, env
+
+  def peek(self):
+    return self.toks[self.pos] if self.pos < len(self.toks) else (None, None)
+
+  def take(self, op=None):
+    t = self.peek()
+    if op is not None and t != ('op', op):
+      raise SpecError('expected "%s"' % op)
+    if t[0] is None:
+      raise SpecError('unexpected end of line')
+    self.pos += 1
+    return t
+
+  def done(self):
+    if self.pos != len(self.toks):
+      raise SpecError('unexpected "%s"' % self.peek()[1])
+
+  def expr(self):
+    c = self.binary(0)
+    if self.peek() == ('op', '?'):
+      self.take()
+      t = self.expr()
+      self.take(':')
+      return Select(c, t, self.expr())
+    return c
+
+  def binary(self, lvl):
+    if lvl == len(self.LEVELS):
+      return self.postfix()
+    l = self.binary(lvl + 1)
+    while self.peek()[0] == 'op' and self.peek()[1] in self.LEVELS[lvl]:
+      op = self.take()[1]
+      l = Bin(op, l, self.binary(lvl + 1))
+    return l
+
+  def postfix(self):
+    x = self.primary()
+    while self.peek() == ('op', '['):
+      self.take()
+      hi = self.width()
+      self.take(':')
+      lo = self.width()
+      self.take(']')
+      x = Slice(x, hi, lo)
+    return x
+
+  def primary(self):
+    kind, v = self.take()
+    if kind == 'num':
+      return Lit(v)
+    if kind == 'op' and v == '(':
+      x = self.expr()
+      self.take(')')
+      return x
+    if kind == 'op' and v == '-' and self.peek()[0] == 'num':
+      return Lit(-self.take()[1])
+    if kind == 'id' and v in FUNCS:
+      self.take('(')
+      nargs, sized, _, _ = FUNCS[v]
+      args = [self.expr()]
+      for _ in range(nargs - 1):
+        self.take(',')
+        args.append(self.expr())
+      n = None
+      if sized:
+        self.take(',')
+        n = self.width()
+      self.take(')')
+      return Call(v, args, n)
+    if kind == 'id' and v in self.env:
+      return self.env[v]
+    raise SpecError('unexpected "%s"' % v)
+
+  # width expressions: integers and W with + - * and parentheses
+  def width(self):
+    w = self.wterm()
+    while self.peek() in (('op', '+'), ('op', '-')):
+      op = self.take()[1]
+      r = self.wterm()
+      w = w + r if op == '+' else w - r
+    return w
+
+  def wterm(self):
+    w = self.watom()
+    while self.peek() == ('op', '*'):
+      self.take()
+      w = w.mul(self.watom())
+    return w
+
+  def watom(self):
+    kind, v = self.take()
+    if kind == 'num':
+      return Width(0, v)
+    if (kind, v) == ('id', 'W'):
+      return Width(1, 0)
+    if (kind, v) == ('op', '('):
+      w = self.width()
+      self.take(')')
+      return w
+    raise SpecError('unexpected "%s" in width' % v)
+
+
+class ElemOp:
+  # params: [(name, width)]
+  def __init__(self, name, params, ret):
+    self.name, self.params, self.ret = name, [p for p, _ in params], ret
+    self.widths = [w for _, w in params]
+    self.env = {p: Var(p, w) for p, w in params}
+    self.lets, self.dst = [], None
+
+  def add(self, line):
+    m = re.fullmatch(r'let\s+(\w+)\s*=(.*)', line)
+    if m:
+      var, body = m.groups()
+      if var in self.env or var in FUNCS or var == 'W':
+        raise SpecError('redefinition of %s' % var)
+      x = self.parse(body)
+      if x.width is None:
+        raise SpecError('%s has no width' % var)
+      self.lets.append((var, x))
+      self.env[var] = Var(var, x.width)
+      return
+    m = re.fullmatch(r'dst\s*=(.*)', line)
+    if not m or self.dst:
+      raise SpecError('expected "let" or a single "dst ="')
+    self.dst = self.parse(m.group(1))
+    if not self.dst.width == self.ret:
+      raise SpecError('dst must have width %s' % self.ret.cpp())
+
+  def parse(self, s):
+    p = Parser(tokenize(s), self.env)
+    x = p.expr()
+    p.done()
+    return x
+
+  # the lane widths W for which the parameters and dst are among the given
+  # widths of the operands and result of an intrinsic
+  def lane_widths(self, bits):
+    return [w for w in sorted(bits)
+            if all(x.at(w) in bits for x in self.widths + [self.ret])]
+
+  def check(self, w):
+    for x in [x for _, x in self.lets] + [self.dst]:
+      for node in x.nodes():
+        try:
+          node.check(w)
+        except SpecError as e:
+          raise SpecError('%s: %s' % (self.name, e))
+
+  def emit(self):
+    def body(k, ty):
+      out = ['    %s %s = %s;' % (ty, v, getattr(x, k)()) for v, x in self.lets]
+      out.append('    return %s;' % getattr(self.dst, k)())
+      return out
+
+    smt, ev = body('smt', 'expr'), body('eval', 'uint64_t')
+    uses_w = lambda lines: any(re.search(r'\bW\b', l) for l in lines)
+    out = ['struct %s {' % self.name]
+    out.append('  static expr smt(%s) {' %
+               ', '.join('const expr &%s' % p for p in self.params))
+    if uses_w(smt):
+      # solve W from the width of the first parameter
+      w0 = self.widths[0]
+      bits = '%s.bits()' % self.params[0]
+      if w0.const:
+        bits = '(%s - %d)' % (bits, w0.const)
+      if w0.coef != 1:
+        bits += ' / %d' % w0.coef
+      out.append('    unsigned W = %s;' % bits)
+    out += smt
+    out.append('  }')
+    out.append('  static uint64_t eval(%s, unsigned%s) {' %
+               (', '.join('uint64_t %s' % p for p in self.params),
+                ' W' if uses_w(ev) else ''))
+    out += ev
+    out.append('  }')
+    out.append('};')
+    return [wrap(l) for l in out]
+
+
+def wrap(line, width=80):
+  # breaks a long generated line at the outermost comma (or operator if
+  # there is none), aligning the rest with the enclosing parenthesis
+  indent = len(line) - len(line.lstrip())
+  out, stack = [], []  # columns of the open parentheses
+  while len(line) > width:
+    best, cur = None, list(stack)
+    for i, c in enumerate(line[:width]):
+      if c in '([':
+        cur.append(i)
+      elif c in ')]':
+        cur.pop()
+      elif c == ',' or line.startswith(' ? ', i) or \
+           line.startswith(' : ', i) or re.match(r' [-+*&|^] ', line[i:]):
+        rank = (len(cur), c != ',')
+        if best is None or rank <= best[0]:
+          best = (rank, i + 1 if c == ',' else i, list(cur))
+    if best is None:
+      break
+    _, i, stack = best
+    col = stack[-1] + 1 if stack else indent + 7
+    out.append(line[:i].rstrip())
+    line = ' ' * col + line[i:].lstrip()
+    # the parentheses still open keep their columns
+  out.append(line)
+  return '\n'.join(out)
+
+
+# an optional width; W if missing
+def parse_width(s):
+  if s is None or not s.strip():
+    return Width(1, 0)
+  p = Parser(tokenize(s), {})
+  w = p.width()
+  p.done()
+  return w
+
+
+def parse_shape(s):
+  m = re.fullmatch(r'(\d+)x(\d+)', s)
+  if not m:
+    raise SpecError('bad shape "%s"; expected LANESxBITS' % s)
+  return int(m.group(1)), int(m.group(2))
+
+
+def parse(path):
+  ops, kinds, records = {}, {}, []
+  cur = None
+  with open(path) as f:
+    for lineno, raw in enumerate(f, 1):
+      line = raw.split('#', 1)[0].rstrip()
+      try:
+        if not line:
+          continue
+        if raw[0].isspace():
+          if cur is None:
+            raise SpecError('indented line outside of an op')
+          cur.add(line.strip())
+          continue
+        if cur is not None and cur.dst is None:
+          raise SpecError('op %s has no "dst ="' % cur.name)
+        cur = None
+        words = line.split()
+        if words[0] == 'op':
+          m = re.fullmatch(r'op\s+(\w+)\(([^()]*(?:\([^()]*\)[^()]*)*)\)'
+                           r'(?:\s*->(.*))?', line)
+          if not m:
+            raise SpecError('expected "op Name(a, b, ...)"')
+          name = m.group(1)
+          if name in ops:
+            raise SpecError('redefinition of op %s' % name)
+          params = []
+          for p in m.group(2).split(','):
+            pm = re.fullmatch(r'\s*(\w+)\s*(?::(.*))?', p)
+            if not pm:
+              raise SpecError('expected "name" or "name: width" parameter')
+            params.append((pm.group(1), parse_width(pm.group(2))))
+          if len(set(p for p, _ in params)) != len(params):
+            raise SpecError('duplicate parameter name')
+          if params[0][1].coef == 0:
+            raise SpecError('the width of the first parameter must use W')
+          cur = ops[name] = ElemOp(name, params, parse_width(m.group(3)))
+        elif words[0] == 'kind':
+          m = re.fullmatch(r'kind\s+(\w+)\s*=\s*(.+)', line)
+          if not m or m.group(1) in kinds:
+            raise SpecError('expected a new "kind name = Kernel"')
+          kinds[m.group(1)] = m.group(2).strip()
+        elif words[0] in ARITY:
+          if len(words) != ARITY[words[0]] + 4:
+            raise SpecError('%s takes a name, a kind and %d shapes' %
+                            (words[0], ARITY[words[0]] + 1))
+          if words[2] not in kinds:
+            raise SpecError('unknown kind %s' % words[2])
+          records.append((words[0], words[1], words[2],
+                          [parse_shape(s) for s in words[3:]], lineno))
+        else:
+          raise SpecError('unknown directive %s' % words[0])
+      except SpecError as e:
+        sys.exit('%s:%d: error: %s' % (path, lineno, e))
+  if cur is not None and cur.dst is None:
+    sys.exit('%s: error: op %s has no "dst ="' % (path, cur.name))
+
+  names = set()
+  for table, name, kind, shapes, lineno in records:
+    try:
+      if name in names:
+        raise SpecError('duplicate intrinsic %s' % name)
+      names.add(name)
+      # check the op for each lane width W it may be instantiated with
+      used = [ops[o] for o in re.findall(r'\w+', kinds[kind]) if o in ops]
+      for op in used:
+        ws = op.lane_widths(set(b for _, b in shapes))
+        if not ws:
+          raise SpecError('the shapes do not match the widths of %s' %
+                          op.name)
+        for w in ws:
+          op.check(w)
+    except SpecError as e:
+      sys.exit('%s:%d: error: %s' % (path, lineno, e))
+  return ops, kinds, records
+
+
+def write(path, text):
+  with open(path, 'w') as f:
+    f.write(text)
+
+
+def main():
+  if len(sys.argv) != 3:
+    sys.exit('usage: %s <spec> <output dir>' % sys.argv[0])
+  ops, kinds, records = parse(sys.argv[1])
+  outdir = os.path.join(sys.argv[2], 'ir')
+  os.makedirs(outdir, exist_ok=True)
+
+  header = '// Generated by scripts/gen-x86-intrinsics.py from ' \
+           'ir/x86_intrinsics.spec.\n// Do not edit.\n'
+  for table, fname in TABLE.items():
+    rows = []
+    for t, name, kind, shapes, _ in records:
+      if t == table:
+        rows.append('PROCESS(%s,%s,%s)\n' %
+                    (name, kind, ','.join('%d,%d' % s for s in shapes)))
+    write(os.path.join(outdir, fname), header + ''.join(rows))
+
+  out = [header]
+  for op in ops.values():
+    out += op.emit()
+    out.append('')
+  width = max(len(k) for k in kinds)
+  for k, v in kinds.items():
+    out.append('using %s = %s;' % (k.ljust(width), v))
+  write(os.path.join(outdir, 'x86_intrinsics_gen.h'), '\n'.join(out) + '\n')
+
+
+if __name__ == '__main__':
+  main()
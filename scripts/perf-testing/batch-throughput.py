@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+# Copyright (c) 2018-present The Alive2 Authors.
+# Distributed under the MIT license that can be found in the LICENSE file.
+
+"""Measures how many function pairs per second alive-tv verifies.
+
+Generates a module with many small src/tgt pairs (the shape of a bitcode file
+split into single functions) and runs alive-tv over it once per requested
+-batch value, printing the throughput reported by -throughput.
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+# Small, cheap transformations; the point is to measure the fixed cost per
+# pair, not the solver.
+TEMPLATES = [
+  ('''define i{w} @src_{n}(i{w} %x) {{
+  %a = add i{w} %x, {k}
+  %b = mul i{w} %a, 2
+  ret i{w} %b
+}}''', '''define i{w} @tgt_{n}(i{w} %x) {{
+  %a = add i{w} %x, {k}
+  %b = shl i{w} %a, 1
+  ret i{w} %b
+}}'''),
+  ('''define i1 @src_{n}(i{w} %x, i{w} %y) {{
+  %a = xor i{w} %x, {k}
+  %b = xor i{w} %y, {k}
+  %c = icmp eq i{w} %a, %b
+  ret i1 %c
+}}''', '''define i1 @tgt_{n}(i{w} %x, i{w} %y) {{
+  %c = icmp eq i{w} %x, %y
+  ret i1 %c
+}}'''),
+  ('''define i{w} @src_{n}(i{w} %x) {{
+  %a = and i{w} %x, {k}
+  %b = or i{w} %a, {k}
+  ret i{w} %b
+}}''', '''define i{w} @tgt_{n}(i{w} %x) {{
+  ret i{w} {k}
+}}'''),
+  ('''define i{w} @src_{n}(i{w} %x, i{w} %y) {{
+  %a = sub i{w} 0, %x
+  %b = sub i{w} %y, %a
+  ret i{w} %b
+}}''', '''define i{w} @tgt_{n}(i{w} %x, i{w} %y) {{
+  %b = add i{w} %y, %x
+  ret i{w} %b
+}}'''),
+]
+
+def gen_module(num):
+  fns = []
+  for n in range(num):
+    src, tgt = TEMPLATES[n % len(TEMPLATES)]
+    w = (8, 16, 32, 64)[(n // len(TEMPLATES)) % 4]
+    k = n % 127 + 1
+    fns.append(src.format(n=n, w=w, k=k))
+    fns.append(tgt.format(n=n, w=w, k=k))
+  return '\n\n'.join(fns) + '\n'
+
+def main():
+  ap = argparse.ArgumentParser(description=__doc__)
+  ap.add_argument('--alive-tv', default='./alive-tv',
+                  help='path to the alive-tv binary')
+  ap.add_argument('-n', type=int, default=2000,
+                  help='number of function pairs (default: 2000)')
+  ap.add_argument('--batch', default='1,0',
+                  help='comma-separated -batch values to compare '
+                       '(default: 1,0)')
+  args = ap.parse_args()
+
+  if not os.access(args.alive_tv, os.X_OK):
+    sys.exit("can't execute '%s'" % args.alive_tv)
+
+  with tempfile.NamedTemporaryFile('w', suffix='.ll') as f:
+    f.write(gen_module(args.n))
+    f.flush()
+    for batch in args.batch.split(','):
+      out = subprocess.run([args.alive_tv, '-quiet', '-throughput',
+                            '-batch=' + batch, f.name],
+                           capture_output=True, text=True).stdout
+      m = re.search(r'^Throughput: (.*)$', out, re.M)
+      ok = re.search(r'(\d+) correct transformations', out)
+      if not m or not ok or int(ok.group(1)) != args.n:
+        sys.exit('-batch=%s: unexpected output:\n%s' % (batch, out))
+      print('-batch=%-4s %s' % (batch, m.group(1)))
+
+if __name__ == '__main__':
+  main()
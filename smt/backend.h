@@ -0,0 +1,46 @@
+#pragma once
+
+// Copyright (c) 2018-present The Alive2 Authors.
+// Distributed under the MIT license that can be found in the LICENSE file.
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <z3.h>
+
+namespace smt {
+
+/*
+ * An SMT solver other than Z3 that decides the queries in the logics it
+ * supports. Expressions are still built with Z3: the backend translates the
+ * assertions of a query into its own terms, and gives a model back as a Z3
+ * model of the calling thread's context.
+ */
+class Backend {
+public:
+  struct Answer {
+    Z3_lbool result = Z3_L_UNDEF;
+    Z3_model model = nullptr; // if SAT; the caller owns one reference
+    std::string reason;       // if UNDEF
+  };
+
+  virtual ~Backend() {}
+
+  virtual const char* name() const = 0;
+
+  // Returns nothing if the query is outside of the backend's logic, e.g.,
+  // it has quantifiers or floats. Z3 should answer it instead.
+  virtual std::optional<Answer> check(Z3_ast fml) = 0;
+};
+
+// Backends compiled in, other than Z3
+bool has_backend(const std::string &name);
+
+// One per thread, as the models belong to the thread's context
+std::unique_ptr<Backend> mk_backend(const std::string &name);
+
+#ifndef NO_BITWUZLA_SUPPORT
+std::unique_ptr<Backend> mk_bitwuzla_backend();
+#endif
+
+}
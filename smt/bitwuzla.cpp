@@ -0,0 +1,290 @@
+// Copyright (c) 2018-present The Alive2 Authors.
+// Distributed under the MIT license that can be found in the LICENSE file.
+
+#include "smt/backend.h"
+#include "smt/ctx.h"
+#include "smt/smt.h"
+#include <bitwuzla/c/bitwuzla.h>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace smt;
+using namespace std;
+
+namespace {
+
+class BitwuzlaBackend final : public Backend {
+  BitwuzlaTermManager *tm = nullptr;
+  Bitwuzla *bzla = nullptr;
+  unordered_map<Z3_ast, BitwuzlaTerm> terms;
+  // the free variables of the query, to build the model
+  vector<pair<Z3_func_decl, BitwuzlaTerm>> vars;
+
+  optional<BitwuzlaSort> mkSort(Z3_sort sort) {
+    switch (Z3_get_sort_kind(ctx(), sort)) {
+    case Z3_BOOL_SORT:
+      return bitwuzla_mk_bool_sort(tm);
+    case Z3_BV_SORT:
+      return bitwuzla_mk_bv_sort(tm, Z3_get_bv_sort_size(ctx(), sort));
+    default:
+      return {};
+    }
+  }
+
+  BitwuzlaTerm mkTerm(BitwuzlaKind kind, vector<BitwuzlaTerm> &args) {
+    return bitwuzla_mk_term(tm, kind, args.size(), args.data());
+  }
+
+  BitwuzlaTerm mkIndexed(BitwuzlaKind kind, vector<BitwuzlaTerm> &args,
+                         Z3_func_decl decl) {
+    uint64_t idxs[2];
+    unsigned n = Z3_get_decl_num_parameters(ctx(), decl);
+    for (unsigned i = 0; i < n; ++i) {
+      idxs[i] = Z3_get_decl_int_parameter(ctx(), decl, i);
+    }
+    return bitwuzla_mk_term_indexed(tm, kind, args.size(), args.data(), n,
+                                    idxs);
+  }
+
+  // Z3's n-ary operators become a left-leaning chain
+  BitwuzlaTerm mkChain(BitwuzlaKind kind, vector<BitwuzlaTerm> &args) {
+    BitwuzlaTerm t = args[0];
+    for (unsigned i = 1; i < args.size(); ++i) {
+      BitwuzlaTerm pair[] = { t, args[i] };
+      t = bitwuzla_mk_term(tm, kind, 2, pair);
+    }
+    return t;
+  }
+
+  // Translates an application whose arguments are translated already.
+  // Returns nothing for operations outside of QF_BV.
+  optional<BitwuzlaTerm> mkApp(Z3_app app, Z3_sort sort,
+                               vector<BitwuzlaTerm> &args) {
+    auto decl = Z3_get_app_decl(ctx(), app);
+    switch (Z3_get_decl_kind(ctx(), decl)) {
+    case Z3_OP_TRUE:     return bitwuzla_mk_true(tm);
+    case Z3_OP_FALSE:    return bitwuzla_mk_false(tm);
+    case Z3_OP_EQ:
+    case Z3_OP_IFF:      return mkTerm(BITWUZLA_KIND_EQUAL, args);
+    case Z3_OP_DISTINCT: return mkTerm(BITWUZLA_KIND_DISTINCT, args);
+    case Z3_OP_ITE:      return mkTerm(BITWUZLA_KIND_ITE, args);
+    case Z3_OP_AND:      return mkChain(BITWUZLA_KIND_AND, args);
+    case Z3_OP_OR:       return mkChain(BITWUZLA_KIND_OR, args);
+    case Z3_OP_XOR:      return mkChain(BITWUZLA_KIND_XOR, args);
+    case Z3_OP_NOT:      return mkTerm(BITWUZLA_KIND_NOT, args);
+    case Z3_OP_IMPLIES:  return mkTerm(BITWUZLA_KIND_IMPLIES, args);
+
+    case Z3_OP_BNEG:     return mkTerm(BITWUZLA_KIND_BV_NEG, args);
+    case Z3_OP_BADD:     return mkChain(BITWUZLA_KIND_BV_ADD, args);
+    case Z3_OP_BSUB:     return mkChain(BITWUZLA_KIND_BV_SUB, args);
+    case Z3_OP_BMUL:     return mkChain(BITWUZLA_KIND_BV_MUL, args);
+    // the _I variants are the same as the SMT-LIB ones, except that Z3
+    // knows the divisor can't be zero
+    case Z3_OP_BSDIV:
+    case Z3_OP_BSDIV_I:  return mkTerm(BITWUZLA_KIND_BV_SDIV, args);
+    case Z3_OP_BUDIV:
+    case Z3_OP_BUDIV_I:  return mkTerm(BITWUZLA_KIND_BV_UDIV, args);
+    case Z3_OP_BSREM:
+    case Z3_OP_BSREM_I:  return mkTerm(BITWUZLA_KIND_BV_SREM, args);
+    case Z3_OP_BUREM:
+    case Z3_OP_BUREM_I:  return mkTerm(BITWUZLA_KIND_BV_UREM, args);
+    case Z3_OP_BSMOD:
+    case Z3_OP_BSMOD_I:  return mkTerm(BITWUZLA_KIND_BV_SMOD, args);
+    case Z3_OP_ULEQ:     return mkTerm(BITWUZLA_KIND_BV_ULE, args);
+    case Z3_OP_SLEQ:     return mkTerm(BITWUZLA_KIND_BV_SLE, args);
+    case Z3_OP_UGEQ:     return mkTerm(BITWUZLA_KIND_BV_UGE, args);
+    case Z3_OP_SGEQ:     return mkTerm(BITWUZLA_KIND_BV_SGE, args);
+    case Z3_OP_ULT:      return mkTerm(BITWUZLA_KIND_BV_ULT, args);
+    case Z3_OP_SLT:      return mkTerm(BITWUZLA_KIND_BV_SLT, args);
+    case Z3_OP_UGT:      return mkTerm(BITWUZLA_KIND_BV_UGT, args);
+    case Z3_OP_SGT:      return mkTerm(BITWUZLA_KIND_BV_SGT, args);
+    case Z3_OP_BAND:     return mkChain(BITWUZLA_KIND_BV_AND, args);
+    case Z3_OP_BOR:      return mkChain(BITWUZLA_KIND_BV_OR, args);
+    case Z3_OP_BXOR:     return mkChain(BITWUZLA_KIND_BV_XOR, args);
+    case Z3_OP_BNOT:     return mkTerm(BITWUZLA_KIND_BV_NOT, args);
+    case Z3_OP_BNAND:    return mkTerm(BITWUZLA_KIND_BV_NAND, args);
+    case Z3_OP_BNOR:     return mkTerm(BITWUZLA_KIND_BV_NOR, args);
+    case Z3_OP_BXNOR:    return mkTerm(BITWUZLA_KIND_BV_XNOR, args);
+    case Z3_OP_BCOMP:    return mkTerm(BITWUZLA_KIND_BV_COMP, args);
+    case Z3_OP_BREDOR:   return mkTerm(BITWUZLA_KIND_BV_REDOR, args);
+    case Z3_OP_BREDAND:  return mkTerm(BITWUZLA_KIND_BV_REDAND, args);
+    case Z3_OP_BSHL:     return mkTerm(BITWUZLA_KIND_BV_SHL, args);
+    case Z3_OP_BLSHR:    return mkTerm(BITWUZLA_KIND_BV_SHR, args);
+    case Z3_OP_BASHR:    return mkTerm(BITWUZLA_KIND_BV_ASHR, args);
+    case Z3_OP_EXT_ROTATE_LEFT:  return mkTerm(BITWUZLA_KIND_BV_ROL, args);
+    case Z3_OP_EXT_ROTATE_RIGHT: return mkTerm(BITWUZLA_KIND_BV_ROR, args);
+    case Z3_OP_CONCAT:   return mkChain(BITWUZLA_KIND_BV_CONCAT, args);
+
+    case Z3_OP_EXTRACT:
+      return mkIndexed(BITWUZLA_KIND_BV_EXTRACT, args, decl);
+    case Z3_OP_SIGN_EXT:
+      return mkIndexed(BITWUZLA_KIND_BV_SIGN_EXTEND, args, decl);
+    case Z3_OP_ZERO_EXT:
+      return mkIndexed(BITWUZLA_KIND_BV_ZERO_EXTEND, args, decl);
+    case Z3_OP_REPEAT:
+      return mkIndexed(BITWUZLA_KIND_BV_REPEAT, args, decl);
+    case Z3_OP_ROTATE_LEFT:
+      return mkIndexed(BITWUZLA_KIND_BV_ROLI, args, decl);
+    case Z3_OP_ROTATE_RIGHT:
+      return mkIndexed(BITWUZLA_KIND_BV_RORI, args, decl);
+
+    case Z3_OP_UNINTERPRETED: {
+      if (!args.empty())
+        return {};
+      auto s = mkSort(sort);
+      if (!s)
+        return {};
+      auto sym = Z3_get_decl_name(ctx(), decl);
+      string name = Z3_get_symbol_kind(ctx(), sym) == Z3_STRING_SYMBOL
+                      ? Z3_get_symbol_string(ctx(), sym) : "";
+      auto var = bitwuzla_mk_const(tm, *s, name.c_str());
+      vars.emplace_back(decl, var);
+      return var;
+    }
+
+    default:
+      return {};
+    }
+  }
+
+  optional<BitwuzlaTerm> translate(Z3_ast root) {
+    // post-order walk; an AST is translated once all its arguments are
+    vector<pair<Z3_ast, bool>> todo = { { root, false } };
+    vector<BitwuzlaTerm> args;
+
+    while (!todo.empty()) {
+      auto [ast, args_done] = todo.back();
+      if (terms.count(ast)) {
+        todo.pop_back();
+        continue;
+      }
+
+      auto sort = Z3_get_sort(ctx(), ast);
+      switch (Z3_get_ast_kind(ctx(), ast)) {
+      case Z3_NUMERAL_AST: {
+        auto s = mkSort(sort);
+        if (!s)
+          return {};
+        terms.emplace(ast, bitwuzla_mk_bv_value(tm, *s,
+                             Z3_get_numeral_string(ctx(), ast), 10));
+        todo.pop_back();
+        break;
+      }
+
+      case Z3_APP_AST: {
+        auto app = Z3_to_app(ctx(), ast);
+        unsigned num_args = Z3_get_app_num_args(ctx(), app);
+        if (!args_done) {
+          todo.back().second = true;
+          for (unsigned i = 0; i < num_args; ++i) {
+            todo.emplace_back(Z3_get_app_arg(ctx(), app, i), false);
+          }
+          break;
+        }
+
+        if (!mkSort(sort))
+          return {};
+        args.clear();
+        for (unsigned i = 0; i < num_args; ++i) {
+          args.emplace_back(terms.at(Z3_get_app_arg(ctx(), app, i)));
+        }
+        auto t = mkApp(app, sort, args);
+        if (!t)
+          return {};
+        terms.emplace(ast, *t);
+        todo.pop_back();
+        break;
+      }
+
+      // quantifiers and their bound variables
+      default:
+        return {};
+      }
+    }
+    return terms.at(root);
+  }
+
+  Z3_model mkModel() {
+    auto m = Z3_mk_model(ctx());
+    Z3_model_inc_ref(ctx(), m);
+    for (auto &[decl, var] : vars) {
+      auto val = bitwuzla_get_value(bzla, var);
+      auto range = Z3_get_range(ctx(), decl);
+      Z3_ast z3val;
+      if (Z3_get_sort_kind(ctx(), range) == Z3_BOOL_SORT)
+        z3val = bitwuzla_term_value_get_bool(val) ? Z3_mk_true(ctx())
+                                                  : Z3_mk_false(ctx());
+      else
+        z3val = Z3_mk_numeral(ctx(),
+                              bitwuzla_term_value_get_str_fmt(val, 10), range);
+      Z3_add_const_interp(ctx(), m, decl, z3val);
+    }
+    return m;
+  }
+
+  void reset() {
+    if (bzla)
+      bitwuzla_delete(bzla);
+    if (tm)
+      bitwuzla_term_manager_delete(tm);
+    bzla = nullptr;
+    tm = nullptr;
+    terms.clear();
+    vars.clear();
+  }
+
+public:
+  ~BitwuzlaBackend() override {
+    reset();
+  }
+
+  const char* name() const override { return "bitwuzla"; }
+
+  optional<Answer> check(Z3_ast fml) override {
+    // a fresh term manager per query, so memory doesn't pile up
+    tm = bitwuzla_term_manager_new();
+    auto options = bitwuzla_options_new();
+    bitwuzla_set_option(options, BITWUZLA_OPT_PRODUCE_MODELS, 1);
+    bitwuzla_set_option(options, BITWUZLA_OPT_SEED,
+                        strtoul(get_random_seed(), nullptr, 10));
+    bitwuzla_set_option(options, BITWUZLA_OPT_TIME_LIMIT_PER,
+                        strtoul(get_query_timeout(), nullptr, 10));
+    bzla = bitwuzla_new(tm, options);
+    bitwuzla_options_delete(options);
+
+    optional<Answer> ret;
+    if (auto t = translate(fml)) {
+      bitwuzla_assert(bzla, *t);
+      ret.emplace();
+      switch (bitwuzla_check_sat(bzla)) {
+      case BITWUZLA_SAT:
+        ret->result = Z3_L_TRUE;
+        ret->model  = mkModel();
+        break;
+      case BITWUZLA_UNSAT:
+        ret->result = Z3_L_FALSE;
+        break;
+      default:
+        // the only limit we set is time
+        ret->reason = "timeout";
+        break;
+      }
+    }
+    reset();
+    return ret;
+  }
+};
+}
+
+namespace smt {
+
+unique_ptr<Backend> mk_bitwuzla_backend() {
+  return make_unique<BitwuzlaBackend>();
+}
+
+}
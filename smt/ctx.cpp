@@ -6,6 +6,7 @@
 #include "util/config.h"
 #include <cstdlib>
 #include <iostream>
+#include <mutex>
 #include <string_view>
 #include <z3.h>
 
@@ -25,9 +26,15 @@ static void z3_error_handler(Z3_context ctx, Z3_error_code err) {
 
 namespace smt {
 
-context ctx;
+thread_local constinit context ctx;
+
+// Protects Z3's global parameters and memory manager, which are shared by
+// the contexts of all threads
+static mutex global_mutex;
+static unsigned num_contexts = 0;
 
 void context::init() {
+  lock_guard lock(global_mutex);
   Z3_global_param_set("model.partial", "true");
   Z3_global_param_set("smt.ematching", "false");
   Z3_global_param_set("smt.mbqi.max_iterations", "1000000");
@@ -39,6 +46,7 @@ void context::init() {
   Z3_global_param_set("rewriter.hi_fp_unspecified", "true");
   ctx = Z3_mk_context_rc(nullptr);
   Z3_set_error_handler(ctx, z3_error_handler);
+  ++num_contexts;
 
   no_timeout_param = Z3_mk_params(ctx);
   Z3_params_inc_ref(ctx, no_timeout_param);
@@ -49,6 +57,22 @@ void context::init() {
 void context::destroy() {
   Z3_params_dec_ref(ctx, no_timeout_param);
   Z3_del_context(ctx);
+  ctx = nullptr;
+
+  lock_guard lock(global_mutex);
+  --num_contexts;
+}
+
+void context::reset_memory() {
+  lock_guard lock(global_mutex);
+  if (num_contexts == 0)
+    Z3_reset_memory();
+}
+
+void context::finalize_memory() {
+  lock_guard lock(global_mutex);
+  if (num_contexts == 0)
+    Z3_finalize_memory();
 }
 
 }
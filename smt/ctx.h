@@ -9,8 +9,8 @@ typedef struct _Z3_params* Z3_params;
 namespace smt {
 
 class context {
-  Z3_context ctx;
-  Z3_params no_timeout_param;
+  Z3_context ctx = nullptr;
+  Z3_params no_timeout_param = nullptr;
 
 public:
   Z3_context operator()() const { return ctx; }
@@ -18,8 +18,14 @@ public:
 
   void init();
   void destroy();
+
+  // Z3_reset_memory() and Z3_finalize_memory() are process-wide; these only
+  // call them when no other thread holds a context
+  static void reset_memory();
+  static void finalize_memory();
 };
 
-extern context ctx;
+// Each thread has its own context (created by smt_initializer).
+extern thread_local constinit context ctx;
 
 }
@@ -4,14 +4,20 @@
 #include "smt/expr.h"
 #include "smt/exprs.h"
 #include "smt/ctx.h"
+#include "util/apint.h"
 #include "util/compiler.h"
 #include <algorithm>
+#include <atomic>
 #include <bit>
+#include <cmath>
 #include <cassert>
 #include <climits>
+#include <iomanip>
 #include <limits>
 #include <memory>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <z3.h>
 
 #define DEBUG_Z3_RC 0
@@ -44,7 +50,15 @@ static Z3_ast mkVar(const char *name, Z3_sort sort) {
   return Z3_mk_const(smt::ctx(), Z3_mk_string_symbol(smt::ctx(), name), sort);
 }
 
-static expr simplify_const(expr &&e) { return e.simplifyNoTimeout(); }
+static expr simplify_const(expr &&e) {
+  auto folded = e.foldConst();
+  if (!folded.isValid())
+    return e.simplifyNoTimeout();
+#ifdef CHECK_CONST_FOLDS
+  assert(folded.eq(e.simplifyNoTimeout()));
+#endif
+  return folded;
+}
 
 template <typename... Exprs>
 static expr simplify_const(expr &&e, const expr &input,
@@ -60,6 +74,87 @@ static expr simplify_const(expr &&e, const expr &input,
   return std::move(e);
 }
 
+namespace {
+
+/*
+ * Memoizes the construction of expressions, per thread. Some operations
+ * pattern-match their operands first, even recursively (e.g., an extract of
+ * a concat or the equality of two concats), and constant operands are folded
+ * with Z3's simplifier. Symbolic execution of vector code builds the same
+ * terms over and over, like the lanes of a vector, so the result is kept for
+ * the operation, its operands and integer parameters. The table holds
+ * references to the operands, so that their ids aren't reused by Z3.
+ */
+class ExprCache {
+public:
+  enum Op : uintptr_t { Extract, Concat, SExt, If, Eq };
+
+private:
+  struct Key {
+    uintptr_t op; // an Op, or the Z3 function to fold
+    unsigned args[3];
+    unsigned params[2];
+    bool operator==(const Key &rhs) const = default;
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key &k) const {
+      size_t h = k.op;
+      for (auto v : { k.args[0], k.args[1], k.args[2], k.params[0],
+                      k.params[1] }) {
+        h = (h ^ v) * 0x9E3779B97F4A7C15ull;
+      }
+      return h;
+    }
+  };
+
+  struct Entry {
+    expr args[3];
+    expr result;
+  };
+
+  // large enough for the lanes of a few 512-bit vectors; it's cleared when
+  // full rather than evicting entries one by one
+  static constexpr size_t max_size = 1 << 16;
+  unordered_map<Key, Entry, KeyHash> table;
+
+  static unsigned id(const expr &e) {
+    return e.isValid() ? e.id() : UINT_MAX;
+  }
+
+public:
+  static atomic<uint64_t> num_lookups, num_hits;
+
+  template <typename Fn>
+  expr get(uintptr_t op, Fn &&fn, const expr &a, const expr &b = {},
+           const expr &c = {}, unsigned p0 = 0, unsigned p1 = 0) {
+    Key key{ op, { id(a), id(b), id(c) }, { p0, p1 } };
+    num_lookups.fetch_add(1, memory_order_relaxed);
+    if (auto I = table.find(key); I != table.end()) {
+      num_hits.fetch_add(1, memory_order_relaxed);
+      return I->second.result;
+    }
+
+    // fn may add entries of its own
+    expr result = fn();
+    if (table.size() >= max_size)
+      table.clear();
+    table.try_emplace(key, Entry{ { a, b, c }, result });
+    return result;
+  }
+
+  void clear() {
+    table.clear();
+  }
+};
+
+atomic<uint64_t> ExprCache::num_lookups = 0;
+atomic<uint64_t> ExprCache::num_hits = 0;
+
+thread_local ExprCache expr_cache;
+
+}
+
 static bool is_power2(const expr &e, unsigned &log) {
   if (e.isZero() || !(e & (e - expr::mkUInt(1, e))).isZero())
     return false;
@@ -201,6 +296,37 @@ expr expr::mkUInt(uint64_t n, const expr &type) {
   return mkUInt(n, type.sort());
 }
 
+expr expr::mkUInt(const vector<uint64_t> &words, unsigned bits) {
+  if (bits <= 64)
+    return mkUInt(words.empty() ? 0 : words[0], bits);
+
+  // Z3 only takes wide numerals as decimal strings
+  unsigned num_limbs = divide_up(bits, 32);
+  vector<uint32_t> limbs;
+  for (unsigned i = 0, e = min((unsigned)words.size() * 2, num_limbs); i != e;
+       ++i) {
+    limbs.emplace_back(words[i / 2] >> (32 * (i % 2)));
+  }
+  if (bits % 32 && limbs.size() == num_limbs)
+    limbs.back() &= (1u << (bits % 32)) - 1;
+
+  string str;
+  do {
+    uint64_t rem = 0;
+    for (auto I = limbs.rbegin(), E = limbs.rend(); I != E; ++I) {
+      uint64_t cur = (rem << 32) | *I;
+      *I  = cur / 10;
+      rem = cur % 10;
+    }
+    str += (char)('0' + rem);
+    while (!limbs.empty() && limbs.back() == 0)
+      limbs.pop_back();
+  } while (!limbs.empty());
+
+  reverse(str.begin(), str.end());
+  return mkInt(str.c_str(), bits);
+}
+
 expr expr::mkInt(int64_t n, Z3_sort sort) {
   return Z3_mk_int64(ctx(), n, sort);
 }
@@ -436,6 +562,28 @@ bool expr::isUInt(uint64_t &n) const {
   return Z3_get_numeral_uint64(ctx(), ast(), &n);
 }
 
+bool expr::isUInt(vector<uint64_t> &words) const {
+  C();
+  if (!Z3_is_numeral_ast(ctx(), ast()) || !isBV())
+    return false;
+
+  auto bw = bits();
+  words.assign(divide_up(bw, 64), 0);
+  if (bw <= 64)
+    return Z3_get_numeral_uint64(ctx(), ast(), words.data());
+
+  for (const char *p = Z3_get_numeral_string(ctx(), ast()); *p; ++p) {
+    uint64_t carry = *p - '0';
+    for (auto &w : words) {
+      uint64_t lo = (w & UINT32_MAX) * 10 + carry;
+      uint64_t hi = (w >> 32) * 10 + (lo >> 32);
+      w = (hi << 32) | (lo & UINT32_MAX);
+      carry = hi >> 32;
+    }
+  }
+  return true;
+}
+
 bool expr::isInt(int64_t &n) const {
   C();
   auto bw = bits();
@@ -666,11 +814,20 @@ expr expr::binop_commutative(const expr &rhs,
 expr expr::binop_fold(const expr &rhs,
                       Z3_ast(*op)(Z3_context, Z3_ast, Z3_ast)) const {
   C(rhs);
+  // only folding constants is expensive
+  if (isConst() && rhs.isConst())
+    return expr_cache.get((uintptr_t)op, [&]() -> expr {
+      return simplify_const(op(ctx(), ast(), rhs()), *this, rhs);
+    }, *this, rhs);
   return simplify_const(op(ctx(), ast(), rhs()), *this, rhs);
 }
 
 expr expr::unop_fold(Z3_ast(*op)(Z3_context, Z3_ast)) const {
   C();
+  if (isConst())
+    return expr_cache.get((uintptr_t)op, [&]() -> expr {
+      return simplify_const(op(ctx(), ast()), *this);
+    }, *this);
   return simplify_const(op(ctx(), ast()), *this);
 }
 
@@ -1395,6 +1552,13 @@ expr expr::operator~() const {
 }
 
 expr expr::cmp_eq(const expr &rhs, bool simplify) const {
+  C(rhs);
+  return expr_cache.get(ExprCache::Eq,
+                        [&]() { return cmp_eq_nocache(rhs, simplify); },
+                        *this, rhs, {}, simplify);
+}
+
+expr expr::cmp_eq_nocache(const expr &rhs, bool simplify) const {
   if (!simplify)
     goto end;
 
@@ -1728,6 +1892,12 @@ expr expr::sext(unsigned amount) const {
   C();
   if (amount == 0)
     return *this;
+  return expr_cache.get(ExprCache::SExt,
+                        [&]() { return sext_nocache(amount); },
+                        *this, {}, {}, amount);
+}
+
+expr expr::sext_nocache(unsigned amount) const {
 
   expr e;
   if (isSignExt(e))
@@ -1760,6 +1930,12 @@ expr expr::zextOrTrunc(unsigned tobw) const {
 }
 
 expr expr::concat(const expr &rhs) const {
+  C(rhs);
+  return expr_cache.get(ExprCache::Concat,
+                        [&]() { return concat_nocache(rhs); }, *this, rhs);
+}
+
+expr expr::concat_nocache(const expr &rhs) const {
   expr a, b, c, d;
   unsigned h, l, h2, l2;
   if (isExtract(a, h, l)) {
@@ -1798,6 +1974,12 @@ expr expr::extract(unsigned high, unsigned low, unsigned depth) const {
   if (low == 0 && high == bits()-1)
     return *this;
 
+  return expr_cache.get(ExprCache::Extract,
+                        [&]() { return extract_nocache(high, low, depth); },
+                        *this, {}, {}, high, (low << 4) | depth);
+}
+
+expr expr::extract_nocache(unsigned high, unsigned low, unsigned depth) const {
   if (depth-- == 0)
     goto end;
 
@@ -2016,6 +2198,12 @@ expr expr::mkIf(const expr &cond, const expr &then, const expr &els) {
     return then;
   if (cond.isFalse())
     return els;
+  return expr_cache.get(ExprCache::If,
+                        [&]() { return mkIf_nocache(cond, then, els); },
+                        cond, then, els);
+}
+
+expr expr::mkIf_nocache(const expr &cond, const expr &then, const expr &els) {
 
   if (then.isTrue())
     return cond || els;
@@ -2087,6 +2275,350 @@ expr expr::simplifyNoTimeout() const {
   return Z3_simplify_ex(ctx(), ast(), ctx.getNoTimeoutParam());
 }
 
+static optional<APInt> get_bv(const expr &e) {
+  vector<uint64_t> words;
+  if (!e.isUInt(words))
+    return {};
+  return APInt(e.bits(), std::move(words));
+}
+
+static expr mk_bv(const APInt &n) {
+  return expr::mkUInt(n.getWords(), n.bits());
+}
+
+namespace {
+// A floating-point numeral as its IEEE bits
+struct FPConst {
+  Z3_sort sort;
+  unsigned ebits, sbits; // sbits includes the hidden bit
+  bool nan;              // the bits of a NaN are unspecified
+  APInt bits;
+
+  bool sign() const { return bits.isNegative(); }
+  APInt exponent() const { return bits.extract(ebits + sbits - 2, sbits - 1); }
+  APInt significand() const { return bits.extract(sbits - 2, 0); }
+  APInt magnitude() const { return bits.extract(ebits + sbits - 2, 0); }
+  bool isZero() const { return !nan && magnitude().isZero(); }
+
+  bool isDouble() const { return ebits == 11 && sbits == 53; }
+  bool isFloat() const { return ebits == 8 && sbits == 24; }
+
+  static optional<FPConst> get(Z3_ast a) {
+    auto c = ctx();
+    if (!Z3_is_numeral_ast(c, a))
+      return {};
+    Z3_sort sort = Z3_get_sort(c, a);
+    if (Z3_get_sort_kind(c, sort) != Z3_FLOATING_POINT_SORT)
+      return {};
+
+    FPConst fp{ sort, Z3_fpa_get_ebits(c, sort), Z3_fpa_get_sbits(c, sort),
+                false, APInt(1) };
+    if (fp.ebits > 32 || fp.sbits > 65)
+      return {};
+
+    unsigned width = fp.ebits + fp.sbits;
+    if (Z3_fpa_is_numeral_nan(c, a)) {
+      fp.nan = true;
+      fp.bits = APInt(width);
+      return fp;
+    }
+
+    int sign;
+    int64_t exp = 0;
+    uint64_t sig = 0;
+    if (!Z3_fpa_get_numeral_sign(c, a, &sign))
+      return {};
+    if (Z3_fpa_is_numeral_inf(c, a)) {
+      exp = (INT64_C(1) << fp.ebits) - 1;
+    } else if (!Z3_fpa_is_numeral_zero(c, a)) {
+      if (!Z3_fpa_get_numeral_exponent_int64(c, a, &exp, true) ||
+          !Z3_fpa_get_numeral_significand_uint64(c, a, &sig))
+        return {};
+    }
+    fp.bits = APInt(1, sign).concat(APInt(fp.ebits, exp))
+                            .concat(APInt(fp.sbits - 1, sig));
+    return fp;
+  }
+
+  static Z3_ast mk(Z3_sort sort, unsigned ebits, unsigned sbits,
+                   const APInt &bits) {
+    auto c = ctx();
+    bool sign = bits.isNegative();
+    uint64_t exp = bits.extract(ebits + sbits - 2, sbits - 1).getLimitedValue();
+    uint64_t sig = bits.extract(sbits - 2, 0).getLimitedValue();
+    int64_t bias = (INT64_C(1) << (ebits - 1)) - 1;
+
+    if (exp == (UINT64_C(1) << ebits) - 1)
+      return sig ? Z3_mk_fpa_nan(c, sort) : Z3_mk_fpa_inf(c, sort, sign);
+    if (exp == 0 && sig == 0)
+      return Z3_mk_fpa_zero(c, sort, sign);
+    // subnormals take the exponent of the zero biased exponent as well
+    return Z3_mk_fpa_numeral_int64_uint64(c, sign, (int64_t)exp - bias, sig,
+                                          sort);
+  }
+
+  Z3_ast mk(const APInt &bits) const {
+    return mk(sort, ebits, sbits, bits);
+  }
+
+  Z3_ast mkNaN() const {
+    return Z3_mk_fpa_nan(ctx(), sort);
+  }
+
+  double toDouble() const {
+    return bit_cast<double>(bits.getLimitedValue());
+  }
+
+  float toFloat() const {
+    return bit_cast<float>((uint32_t)bits.getLimitedValue());
+  }
+
+  Z3_ast mk(double n) const {
+    return isnan(n) ? mkNaN() : mk(APInt(64, bit_cast<uint64_t>(n)));
+  }
+
+  Z3_ast mk(float n) const {
+    return isnan(n) ? mkNaN() : mk(APInt(32, bit_cast<uint32_t>(n)));
+  }
+};
+}
+
+template <typename T>
+static T fp_arith(int kind, T a, T b, T c) {
+  switch (kind) {
+  case Z3_OP_FPA_ADD:  return a + b;
+  case Z3_OP_FPA_SUB:  return a - b;
+  case Z3_OP_FPA_MUL:  return a * b;
+  case Z3_OP_FPA_DIV:  return a / b;
+  case Z3_OP_FPA_SQRT: return std::sqrt(a);
+  case Z3_OP_FPA_FMA:  return std::fma(a, b, c);
+  default: UNREACHABLE();
+  }
+}
+
+// -1, 0, 1, or 2 if unordered
+static int fp_compare(const FPConst &a, const FPConst &b) {
+  if (a.nan || b.nan)
+    return 2;
+  if (a.isZero() && b.isZero())
+    return 0;
+  if (a.sign() != b.sign())
+    return a.sign() ? -1 : 1;
+
+  auto mag_a = a.magnitude(), mag_b = b.magnitude();
+  int cmp = mag_a == mag_b ? 0 : (mag_a.ult(mag_b) ? -1 : 1);
+  return a.sign() ? -cmp : cmp;
+}
+
+expr expr::foldConst() const {
+  auto app = isApp();
+  if (!app)
+    return {};
+
+  unsigned num_args = Z3_get_app_num_args(ctx(), app);
+  if (num_args == 0)
+    return {};
+  auto d = Z3_get_app_decl(ctx(), app);
+  auto kind = Z3_get_decl_kind(ctx(), d);
+
+  vector<expr> args;
+  for (unsigned i = 0; i < num_args; ++i) {
+    args.push_back(Z3_get_app_arg(ctx(), app, i));
+  }
+
+  switch (kind) {
+  case Z3_OP_BADD:
+  case Z3_OP_BMUL:
+  case Z3_OP_BAND:
+  case Z3_OP_BOR:
+  case Z3_OP_BXOR:
+  case Z3_OP_CONCAT: {
+    auto r = get_bv(args[0]);
+    if (!r)
+      return {};
+    for (unsigned i = 1; i < num_args; ++i) {
+      auto n = get_bv(args[i]);
+      if (!n)
+        return {};
+      switch (kind) {
+      case Z3_OP_BADD:   *r = *r + *n; break;
+      case Z3_OP_BMUL:   *r = *r * *n; break;
+      case Z3_OP_BAND:   *r = *r & *n; break;
+      case Z3_OP_BOR:    *r = *r | *n; break;
+      case Z3_OP_BXOR:   *r = *r ^ *n; break;
+      case Z3_OP_CONCAT: *r = r->concat(*n); break;
+      default: UNREACHABLE();
+      }
+    }
+    return mk_bv(*r);
+  }
+
+  case Z3_OP_BNOT:
+  case Z3_OP_BNEG:
+  case Z3_OP_EXTRACT:
+  case Z3_OP_SIGN_EXT:
+  case Z3_OP_ZERO_EXT: {
+    auto a = get_bv(args[0]);
+    if (!a || num_args != 1)
+      return {};
+    switch (kind) {
+    case Z3_OP_BNOT: return mk_bv(~*a);
+    case Z3_OP_BNEG: return mk_bv(-*a);
+    case Z3_OP_EXTRACT:
+      return mk_bv(a->extract(Z3_get_decl_int_parameter(ctx(), d, 0),
+                              Z3_get_decl_int_parameter(ctx(), d, 1)));
+    case Z3_OP_SIGN_EXT:
+      return mk_bv(a->sext(Z3_get_decl_int_parameter(ctx(), d, 0)));
+    case Z3_OP_ZERO_EXT:
+      return mk_bv(a->zext(Z3_get_decl_int_parameter(ctx(), d, 0)));
+    default: UNREACHABLE();
+    }
+  }
+
+  case Z3_OP_BSUB:
+  case Z3_OP_BUDIV:
+  case Z3_OP_BSDIV:
+  case Z3_OP_BUREM:
+  case Z3_OP_BSREM:
+  case Z3_OP_BSHL:
+  case Z3_OP_BLSHR:
+  case Z3_OP_BASHR:
+  case Z3_OP_ULEQ:
+  case Z3_OP_SLEQ:
+  case Z3_OP_ULT:
+  case Z3_OP_SLT: {
+    if (num_args != 2)
+      return {};
+    auto a = get_bv(args[0]), b = get_bv(args[1]);
+    if (!a || !b)
+      return {};
+    switch (kind) {
+    case Z3_OP_BSUB:  return mk_bv(*a - *b);
+    case Z3_OP_BUDIV: return mk_bv(a->udiv(*b));
+    case Z3_OP_BSDIV: return mk_bv(a->sdiv(*b));
+    case Z3_OP_BUREM: return mk_bv(a->urem(*b));
+    case Z3_OP_BSREM: return mk_bv(a->srem(*b));
+    case Z3_OP_BSHL:  return mk_bv(a->shl(b->getLimitedValue()));
+    case Z3_OP_BLSHR: return mk_bv(a->lshr(b->getLimitedValue()));
+    case Z3_OP_BASHR: return mk_bv(a->ashr(b->getLimitedValue()));
+    case Z3_OP_ULEQ:  return a->ule(*b);
+    case Z3_OP_SLEQ:  return a->sle(*b);
+    case Z3_OP_ULT:   return a->ult(*b);
+    case Z3_OP_SLT:   return a->slt(*b);
+    default: UNREACHABLE();
+    }
+  }
+
+  case Z3_OP_FPA_IS_NAN:
+  case Z3_OP_FPA_IS_INF:
+  case Z3_OP_FPA_IS_ZERO:
+  case Z3_OP_FPA_IS_NORMAL:
+  case Z3_OP_FPA_IS_SUBNORMAL:
+  case Z3_OP_FPA_IS_NEGATIVE:
+  case Z3_OP_FPA_ABS:
+  case Z3_OP_FPA_NEG:
+  case Z3_OP_FPA_TO_IEEE_BV: {
+    auto a = FPConst::get(args[0]());
+    if (!a)
+      return {};
+    auto exp = a->exponent();
+    bool exp_ones = (~exp).isZero(), exp_zero = exp.isZero();
+    bool sig_zero = a->significand().isZero();
+
+    switch (kind) {
+    case Z3_OP_FPA_IS_NAN:       return a->nan;
+    case Z3_OP_FPA_IS_INF:       return !a->nan && exp_ones;
+    case Z3_OP_FPA_IS_ZERO:      return a->isZero();
+    case Z3_OP_FPA_IS_NORMAL:    return !a->nan && !exp_zero && !exp_ones;
+    case Z3_OP_FPA_IS_SUBNORMAL: return !a->nan && exp_zero && !sig_zero;
+    case Z3_OP_FPA_IS_NEGATIVE:  return !a->nan && a->sign();
+    case Z3_OP_FPA_ABS:
+      if (a->nan)
+        return a->mkNaN();
+      return a->mk(a->magnitude().zext(1));
+    case Z3_OP_FPA_NEG:
+      if (a->nan)
+        return a->mkNaN();
+      return a->mk(APInt(1, !a->sign()).concat(a->magnitude()));
+    case Z3_OP_FPA_TO_IEEE_BV:
+      if (a->nan)
+        return {};
+      return mk_bv(a->bits);
+    default: UNREACHABLE();
+    }
+  }
+
+  case Z3_OP_FPA_EQ:
+  case Z3_OP_FPA_LT:
+  case Z3_OP_FPA_GT:
+  case Z3_OP_FPA_LE:
+  case Z3_OP_FPA_GE: {
+    if (num_args != 2)
+      return {};
+    auto a = FPConst::get(args[0]()), b = FPConst::get(args[1]());
+    if (!a || !b)
+      return {};
+    int cmp = fp_compare(*a, *b);
+    switch (kind) {
+    case Z3_OP_FPA_EQ: return cmp == 0;
+    case Z3_OP_FPA_LT: return cmp == -1;
+    case Z3_OP_FPA_GT: return cmp == 1;
+    case Z3_OP_FPA_LE: return cmp == -1 || cmp == 0;
+    case Z3_OP_FPA_GE: return cmp == 1 || cmp == 0;
+    default: UNREACHABLE();
+    }
+  }
+
+  case Z3_OP_FPA_TO_FP: {
+    // only the reinterpretation of a bit-vector
+    if (num_args != 1)
+      return {};
+    auto a = get_bv(args[0]);
+    auto sort = Z3_get_range(ctx(), d);
+    if (!a)
+      return {};
+    unsigned ebits = Z3_fpa_get_ebits(ctx(), sort);
+    unsigned sbits = Z3_fpa_get_sbits(ctx(), sort);
+    if (ebits > 32 || sbits > 65)
+      return {};
+    return FPConst::mk(sort, ebits, sbits, *a);
+  }
+
+  // The arithmetic is done by the host's IEEE operations, so only
+  // single/double precision with the default rounding mode are folded.
+  case Z3_OP_FPA_ADD:
+  case Z3_OP_FPA_SUB:
+  case Z3_OP_FPA_MUL:
+  case Z3_OP_FPA_DIV:
+  case Z3_OP_FPA_SQRT:
+  case Z3_OP_FPA_FMA: {
+    if (!args[0].isAppOf(Z3_OP_FPA_RM_NEAREST_TIES_TO_EVEN))
+      return {};
+    vector<FPConst> ops;
+    for (unsigned i = 1; i < num_args; ++i) {
+      auto op = FPConst::get(args[i]());
+      if (!op)
+        return {};
+      if (op->nan)
+        return op->mkNaN();
+      ops.emplace_back(std::move(*op));
+    }
+    auto &a = ops[0];
+    auto arg = [&](unsigned i) { return i < ops.size() ? ops[i] : a; };
+    if (a.isDouble())
+      return a.mk(fp_arith(kind, a.toDouble(), arg(1).toDouble(),
+                           arg(2).toDouble()));
+    if (a.isFloat())
+      return a.mk(fp_arith(kind, a.toFloat(), arg(1).toFloat(),
+                           arg(2).toFloat()));
+    return {};
+  }
+
+  default:
+    return {};
+  }
+}
+
 expr expr::foldTopLevel() const {
   expr cond, then, els;
   if (isIf(cond, then, els))
@@ -2104,7 +2636,7 @@ expr expr::foldTopLevel() const {
         break;
     }
     if (is_const)
-      return simplifyNoTimeout();
+      return simplify_const(expr(*this));
   }
   return *this;
 }
@@ -2324,4 +2856,17 @@ unsigned expr::hash() const {
   return Z3_get_ast_hash(ctx(), ast());
 }
 
+void expr_cache_clear() {
+  expr_cache.clear();
+}
+
+void expr_cache_print_stats(ostream &os) {
+  uint64_t lookups = ExprCache::num_lookups;
+  if (lookups == 0)
+    return;
+  uint64_t hits = ExprCache::num_hits;
+  os << "Expr cache hits: " << hits << " / " << lookups << " lookups ("
+     << fixed << setprecision(1) << (100.0 * hits / lookups) << "%)\n";
+}
+
 }
@@ -48,6 +48,14 @@ class expr {
   expr binop_fold(const expr &rhs,
                   Z3_ast(*op)(Z3_context, Z3_ast, Z3_ast)) const;
 
+  // The operations below are memoized; these do the actual work
+  expr cmp_eq_nocache(const expr &rhs, bool simplify) const;
+  expr sext_nocache(unsigned amount) const;
+  expr concat_nocache(const expr &rhs) const;
+  expr extract_nocache(unsigned high, unsigned low, unsigned depth) const;
+  static expr mkIf_nocache(const expr &cond, const expr &then,
+                           const expr &els);
+
   bool alwaysFalse() const { return false; }
 
   static Z3_ast mkTrue();
@@ -76,6 +84,8 @@ public:
 
   static expr mkUInt(uint64_t n, unsigned bits);
   static expr mkUInt(uint64_t n, const expr &type);
+  // arbitrary-width numeral; words are given least significant first
+  static expr mkUInt(const std::vector<uint64_t> &words, unsigned bits);
   static expr mkInt(int64_t n, unsigned bits);
   static expr mkInt(int64_t n, const expr &type);
   static expr mkInt(const char *n, unsigned bits);
@@ -125,6 +135,8 @@ public:
 
   unsigned bits() const;
   bool isUInt(uint64_t &n) const;
+  // arbitrary-width numeral; words are returned least significant first
+  bool isUInt(std::vector<uint64_t> &words) const;
   bool isInt(int64_t &n) const;
   bool isSameTypeOf(const expr &other) const;
 
@@ -347,6 +359,9 @@ public:
   expr simplifyNoTimeout() const;
 
   expr foldTopLevel() const;
+  // Evaluates an operation over constants without calling Z3's simplifier.
+  // Returns an invalid expr for the operations it doesn't know.
+  expr foldConst() const;
 
   // replace v1 -> v2
   expr subst(const std::vector<std::pair<expr, expr>> &repls) const;
@@ -402,4 +417,9 @@ static expr mkIf_fold_fn(const expr &cond, T1 &&a, T2 &&b) {
   return expr::mkIf(cond, a(), b());
 }
 
+// The memoization table of expression constructions holds references to the
+// context's ASTs, so it must be cleared before the context is destroyed
+void expr_cache_clear();
+void expr_cache_print_stats(std::ostream &os);
+
 }
@@ -5,6 +5,7 @@
 
 #include "smt/expr.h"
 #include "util/compiler.h"
+#include "util/cow.h"
 #include <cassert>
 #include <compare>
 #include <map>
@@ -187,7 +188,8 @@ public:
 
 
 class FunctionExpr {
-  std::map<expr, expr> fn; // key -> val
+  // key -> val; shared by copies, e.g., the memory states of each CFG edge
+  util::COW<std::map<expr, expr>> fn;
   std::optional<expr> default_val;
 
 public:
@@ -202,9 +204,9 @@ public:
 
   FunctionExpr simplify() const;
 
-  auto begin() const { return fn.begin(); }
-  auto end() const { return fn.end(); }
-  bool empty() const { return fn.empty() && !default_val; }
+  auto begin() const { return fn->begin(); }
+  auto end() const { return fn->end(); }
+  bool empty() const { return fn->empty() && !default_val; }
 
   std::weak_ordering operator<=>(const FunctionExpr &rhs) const;
 
@@ -0,0 +1,489 @@
+// Copyright (c) 2018-present The Alive2 Authors.
+// Distributed under the MIT license that can be found in the LICENSE file.
+
+#include "smt/querycache.h"
+#include "smt/ctx.h"
+#include "util/crc.h"
+#include "util/file.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+using namespace std;
+using namespace util;
+namespace fs = std::filesystem;
+
+static constexpr size_t max_lru_size = 1 << 14;
+
+template <typename T>
+static T read_at(const char *p) {
+  T v;
+  memcpy(&v, p, sizeof(T));
+  return v;
+}
+
+template <typename T>
+static void append(string &s, T v) {
+  s.append((const char*)&v, sizeof(T));
+}
+
+namespace {
+
+bool is_commutative(Z3_decl_kind kind) {
+  switch (kind) {
+  case Z3_OP_EQ:
+  case Z3_OP_DISTINCT:
+  case Z3_OP_AND:
+  case Z3_OP_OR:
+  case Z3_OP_XOR:
+  case Z3_OP_ADD:
+  case Z3_OP_MUL:
+  case Z3_OP_BADD:
+  case Z3_OP_BMUL:
+  case Z3_OP_BAND:
+  case Z3_OP_BOR:
+  case Z3_OP_BXOR:
+  case Z3_OP_FPA_EQ:
+    return true;
+  default:
+    return false;
+  }
+}
+
+/*
+ * Z3 orders the operands of commutative operations by AST id, which depends
+ * on the creation order of the variables. Hence the hash is computed in two
+ * passes: the first one ignores the identity of the variables (only their
+ * sorts matter) and is used to sort the operands of commutative operations;
+ * the second one numbers the variables as they are found in that order.
+ */
+class Canonicalizer {
+  Z3_context c = smt::ctx();
+  unordered_map<Z3_ast, Hash128> shapes, hashes;
+  unordered_map<Z3_sort, Hash128> sort_hashes;
+  unordered_map<Z3_func_decl, Hash128> decl_hashes;
+  unordered_map<Z3_func_decl, unsigned> var_ids;
+  vector<uint64_t> buf;
+  bool number_vars = false;
+
+  void add(const Hash128 &h) {
+    buf.push_back(h.lo);
+    buf.push_back(h.hi);
+  }
+
+  void add(const string_view &str) {
+    add(hash128(str.data(), str.size()));
+  }
+
+  Hash128 sort(Z3_sort s) {
+    auto [I, inserted] = sort_hashes.try_emplace(s);
+    if (inserted)
+      I->second = hash128(Z3_sort_to_string(c, s));
+    return I->second;
+  }
+
+  Hash128 var(Z3_func_decl d) {
+    vector<uint64_t> data{ 0, 0 };
+    if (number_vars) {
+      auto [I, inserted] = var_ids.try_emplace(d, var_ids.size());
+      if (inserted)
+        vars.push_back(d);
+      data[1] = I->second + 1;
+    }
+
+    for (unsigned i = 0, e = Z3_get_domain_size(c, d); i != e; ++i) {
+      auto h = sort(Z3_get_domain(c, d, i));
+      data.push_back(h.lo);
+      data.push_back(h.hi);
+    }
+    return hash128(data.data(), data.size() * sizeof(uint64_t));
+  }
+
+  Hash128 decl(Z3_func_decl d) {
+    if (Z3_get_decl_kind(c, d) == Z3_OP_UNINTERPRETED)
+      return var(d);
+
+    auto I = decl_hashes.find(d);
+    if (I != decl_hashes.end())
+      return I->second;
+
+    // the kind alone doesn't tell apart, e.g., the internal operations
+    string str = Z3_get_symbol_string(c, Z3_get_decl_name(c, d));
+    str += '\0';
+    str += to_string(Z3_get_decl_kind(c, d));
+    for (unsigned i = 0, e = Z3_get_decl_num_parameters(c, d); i != e; ++i) {
+      str += '\0';
+      switch (Z3_get_decl_parameter_kind(c, d, i)) {
+      case Z3_PARAMETER_INT:
+        str += to_string(Z3_get_decl_int_parameter(c, d, i));
+        break;
+      case Z3_PARAMETER_DOUBLE:
+        str += to_string(Z3_get_decl_double_parameter(c, d, i));
+        break;
+      case Z3_PARAMETER_RATIONAL:
+        str += Z3_get_decl_rational_parameter(c, d, i);
+        break;
+      case Z3_PARAMETER_SYMBOL:
+        str += Z3_get_symbol_string(c, Z3_get_decl_symbol_parameter(c, d, i));
+        break;
+      case Z3_PARAMETER_SORT:
+        str += sort(Z3_get_decl_sort_parameter(c, d, i)).str();
+        break;
+      case Z3_PARAMETER_AST:
+        str += Z3_ast_to_string(c, Z3_get_decl_ast_parameter(c, d, i));
+        break;
+      case Z3_PARAMETER_FUNC_DECL:
+        // e.g., as-array of an uninterpreted function; not cached as it
+        // depends on the numbering
+        return hash128(str + var(Z3_get_decl_func_decl_parameter(c, d, i))
+                               .str());
+      }
+    }
+    return decl_hashes[d] = hash128(str);
+  }
+
+  // Operands in canonical order if sorted (needs their shapes)
+  void children(Z3_ast a, vector<Z3_ast> &out, bool sorted) const {
+    out.clear();
+    switch (Z3_get_ast_kind(c, a)) {
+    case Z3_APP_AST: {
+      auto app = Z3_to_app(c, a);
+      for (unsigned i = 0, e = Z3_get_app_num_args(c, app); i != e; ++i) {
+        out.push_back(Z3_get_app_arg(c, app, i));
+      }
+      if (sorted && out.size() > 1 &&
+          is_commutative(Z3_get_decl_kind(c, Z3_get_app_decl(c, app))))
+        stable_sort(out.begin(), out.end(), [&](auto a, auto b) {
+          auto &ha = shapes.at(a), &hb = shapes.at(b);
+          return ha.hi != hb.hi ? ha.hi < hb.hi : ha.lo < hb.lo;
+        });
+      break;
+    }
+    case Z3_QUANTIFIER_AST:
+      out.push_back(Z3_get_quantifier_body(c, a));
+      break;
+    default:
+      break;
+    }
+  }
+
+  // Each node is hashed from its kind, sort, and operands
+  Hash128 node(Z3_ast a, const vector<Z3_ast> &args,
+               const unordered_map<Z3_ast, Hash128> &map) {
+    buf.clear();
+    switch (Z3_get_ast_kind(c, a)) {
+    case Z3_NUMERAL_AST:
+      buf.push_back(1);
+      add(Z3_get_numeral_string(c, a));
+      break;
+
+    case Z3_APP_AST: {
+      auto d = Z3_get_app_decl(c, Z3_to_app(c, a));
+      buf.push_back(2);
+      // non-numeral values, e.g., floats or rounding modes
+      if (args.empty() && Z3_get_decl_kind(c, d) != Z3_OP_UNINTERPRETED)
+        add(Z3_ast_to_string(c, a));
+      else
+        add(decl(d));
+      for (auto arg : args) {
+        add(map.at(arg));
+      }
+      break;
+    }
+
+    case Z3_VAR_AST:
+      buf.push_back(3);
+      buf.push_back(Z3_get_index_value(c, a));
+      break;
+
+    case Z3_QUANTIFIER_AST:
+      buf.push_back(4);
+      buf.push_back(Z3_is_quantifier_forall(c, a) ? 0 :
+                    Z3_is_quantifier_exists(c, a) ? 1 : 2);
+      for (unsigned i = 0, e = Z3_get_quantifier_num_bound(c, a); i != e; ++i){
+        add(sort(Z3_get_quantifier_bound_sort(c, a, i)));
+      }
+      add(map.at(args[0]));
+      break;
+
+    default:
+      buf.push_back(5);
+      add(Z3_ast_to_string(c, a));
+      break;
+    }
+    add(sort(Z3_get_sort(c, a)));
+    return hash128(buf.data(), buf.size() * sizeof(uint64_t));
+  }
+
+  // iterative post-order DFS as the formulas can be deep
+  void hashAll(Z3_ast root, unordered_map<Z3_ast, Hash128> &map) {
+    vector<pair<Z3_ast, bool>> todo = { { root, false } };
+    vector<Z3_ast> args;
+    while (!todo.empty()) {
+      auto [a, expanded] = todo.back();
+      if (map.count(a)) {
+        todo.pop_back();
+        continue;
+      }
+      children(a, args, expanded || number_vars);
+      if (expanded) {
+        todo.pop_back();
+        map.emplace(a, node(a, args, map));
+        continue;
+      }
+      todo.back().second = true;
+      for (auto I = args.rbegin(), E = args.rend(); I != E; ++I) {
+        if (!map.count(*I))
+          todo.emplace_back(*I, false);
+      }
+    }
+  }
+
+public:
+  vector<Z3_func_decl> vars;
+
+  Hash128 operator()(Z3_ast root) {
+    hashAll(root, shapes);
+    number_vars = true;
+    hashAll(root, hashes);
+    return hashes.at(root);
+  }
+};
+
+// Values built only from numerals and interpreted operations (e.g., constant
+// arrays), so they can be printed and parsed back in another query
+bool is_closed_value(Z3_context c, Z3_ast root) {
+  vector<Z3_ast> todo = { root };
+  while (!todo.empty()) {
+    Z3_ast a = todo.back();
+    todo.pop_back();
+    switch (Z3_get_ast_kind(c, a)) {
+    case Z3_NUMERAL_AST:
+      break;
+    case Z3_APP_AST: {
+      auto app = Z3_to_app(c, a);
+      auto kind = Z3_get_decl_kind(c, Z3_get_app_decl(c, app));
+      if (kind == Z3_OP_UNINTERPRETED || kind == Z3_OP_AS_ARRAY ||
+          kind == Z3_OP_INTERNAL)
+        return false;
+      for (unsigned i = 0, e = Z3_get_app_num_args(c, app); i != e; ++i) {
+        todo.push_back(Z3_get_app_arg(c, app, i));
+      }
+      break;
+    }
+    default:
+      return false;
+    }
+  }
+  return true;
+}
+
+}
+
+namespace smt {
+
+QueryCache::Query::Query(Z3_ast fml) {
+  Canonicalizer canon;
+  key = canon(fml);
+  vars = std::move(canon.vars);
+}
+
+bool QueryCache::Answer::setModel(const Query &q, Z3_model m) {
+  auto c = ctx();
+  unordered_map<Z3_func_decl, unsigned> ids;
+  for (unsigned i = 0, e = q.vars.size(); i != e; ++i) {
+    ids.emplace(q.vars[i], i);
+  }
+
+  for (unsigned i = 0, e = Z3_model_get_num_funcs(c, m); i != e; ++i) {
+    if (ids.count(Z3_model_get_func_decl(c, m, i)))
+      return false;
+  }
+
+  model.clear();
+  for (unsigned i = 0, e = Z3_model_get_num_consts(c, m); i != e; ++i) {
+    auto d = Z3_model_get_const_decl(c, m, i);
+    auto I = ids.find(d);
+    // e.g., a variable eliminated by a tactic
+    if (I == ids.end())
+      continue;
+    auto val = Z3_model_get_const_interp(c, m, d);
+    if (!val || !is_closed_value(c, val))
+      return false;
+    model.emplace_back(I->second, Z3_ast_to_string(c, val));
+  }
+  return true;
+}
+
+Z3_model QueryCache::Answer::getModel(const Query &q) const {
+  auto c = ctx();
+  auto m = Z3_mk_model(c);
+  Z3_model_inc_ref(c, m);
+
+  auto sym = Z3_mk_string_symbol(c, "v");
+  for (auto &[idx, val] : model) {
+    if (idx >= q.vars.size()) {
+      Z3_model_dec_ref(c, m);
+      return nullptr;
+    }
+    auto d = q.vars[idx];
+    string fml = "(assert (= v " + val + "))";
+    auto vect = Z3_parse_smtlib2_string(c, fml.c_str(), 0, nullptr, nullptr,
+                                        1, &sym, &d);
+    Z3_ast_vector_inc_ref(c, vect);
+    auto eq = Z3_to_app(c, Z3_ast_vector_get(c, vect, 0));
+    Z3_add_const_interp(c, m, d, Z3_get_app_arg(c, eq, 1));
+    Z3_ast_vector_dec_ref(c, vect);
+  }
+  return m;
+}
+
+/*
+ * Layout (in the machine's endianness): u8 is SAT, f32 time, u32 number of
+ * values, and per value: u32 index of the constant, u32 length, the value
+ */
+string QueryCache::Answer::serialize() const {
+  string data;
+  append(data, (uint8_t)sat);
+  append(data, time);
+  append(data, (uint32_t)model.size());
+  for (auto &[idx, val] : model) {
+    append(data, (uint32_t)idx);
+    append(data, (uint32_t)val.size());
+    data += val;
+  }
+  return data;
+}
+
+optional<QueryCache::Answer> QueryCache::Answer::deserialize(string_view data) {
+  if (data.size() < 9 || (uint8_t)data[0] > 1)
+    return {};
+
+  Answer ans;
+  ans.sat  = data[0];
+  ans.time = read_at<float>(data.data() + 1);
+  unsigned num_values = read_at<uint32_t>(data.data() + 5);
+  data.remove_prefix(9);
+
+  for (unsigned i = 0; i != num_values; ++i) {
+    if (data.size() < 8)
+      return {};
+    unsigned idx = read_at<uint32_t>(data.data());
+    size_t size  = read_at<uint32_t>(data.data() + 4);
+    data.remove_prefix(8);
+    if (data.size() < size)
+      return {};
+    ans.model.emplace_back(idx, data.substr(0, size));
+    data.remove_prefix(size);
+  }
+  if (!data.empty() || (!ans.sat && !ans.model.empty()))
+    return {};
+  return ans;
+}
+
+
+/*
+ * Each answer is stored in dir/xx/yyyy, where xxyyyy is the key in hex.
+ * The file has the magic "ALIVE2Q\1", u64 CRC of the rest, u64 key.lo,
+ * u64 key.hi, and the serialized answer. It's written to a temporary file
+ * and renamed, so readers never see a partial file.
+ */
+static const char file_magic[8] = { 'A', 'L', 'I', 'V', 'E', '2', 'Q', 1 };
+static constexpr size_t file_header_size = 32;
+
+QueryCache::QueryCache(string dir) : dir(std::move(dir)) {}
+
+string QueryCache::path(const Hash128 &key) const {
+  auto str = key.str();
+  return (fs::path(dir) / str.substr(0, 2) / str.substr(2)).string();
+}
+
+void QueryCache::insert(const Hash128 &key, const Answer &answer) {
+  if (auto I = index.find(key); I != index.end()) {
+    lru.splice(lru.begin(), lru, I->second);
+    I->second->second = answer;
+    return;
+  }
+  lru.emplace_front(key, answer);
+  index.emplace(key, lru.begin());
+  if (lru.size() > max_lru_size) {
+    index.erase(lru.back().first);
+    lru.pop_back();
+  }
+}
+
+optional<QueryCache::Answer>
+QueryCache::lookup(const Hash128 &key, bool &from_disk) {
+  from_disk = false;
+  {
+    lock_guard lock(mutex);
+    if (auto I = index.find(key); I != index.end()) {
+      lru.splice(lru.begin(), lru, I->second);
+      return I->second->second;
+    }
+  }
+
+  if (dir.empty())
+    return {};
+
+  ifstream file(path(key), ios::binary);
+  if (!file)
+    return {};
+  string data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+  if (data.size() < file_header_size ||
+      memcmp(data.data(), file_magic, sizeof(file_magic)) ||
+      read_at<uint64_t>(data.data() + 8) !=
+        crc_finalize(crc_update(crc_init(), data.data() + 16,
+                                data.size() - 16)) ||
+      read_at<uint64_t>(data.data() + 16) != key.lo ||
+      read_at<uint64_t>(data.data() + 24) != key.hi)
+    return {};
+
+  auto ans = Answer::deserialize(string_view(data).substr(file_header_size));
+  if (ans) {
+    from_disk = true;
+    lock_guard lock(mutex);
+    insert(key, *ans);
+  }
+  return ans;
+}
+
+void QueryCache::store(const Hash128 &key, const Answer &answer) {
+  {
+    lock_guard lock(mutex);
+    insert(key, answer);
+  }
+
+  if (dir.empty())
+    return;
+
+  string data(file_magic, sizeof(file_magic));
+  append(data, (uint64_t)0);
+  append(data, key.lo);
+  append(data, key.hi);
+  data += answer.serialize();
+  uint64_t crc = crc_finalize(crc_update(crc_init(), data.data() + 16,
+                                         data.size() - 16));
+  memcpy(data.data() + 8, &crc, sizeof(crc));
+
+  // errors are ignored as it's only an optimization
+  fs::path file = path(key);
+  error_code ec;
+  fs::create_directories(file.parent_path(), ec);
+  if (ec)
+    return;
+  auto tmp = get_random_filename(file.parent_path().string(), "tmp");
+  {
+    ofstream out(tmp, ios::binary);
+    if (!out.write(data.data(), data.size()))
+      return;
+  }
+  fs::rename(tmp, file, ec);
+  if (ec)
+    fs::remove(tmp, ec);
+}
+
+}
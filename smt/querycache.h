@@ -0,0 +1,74 @@
+#pragma once
+
+// Copyright (c) 2018-present The Alive2 Authors.
+// Distributed under the MIT license that can be found in the LICENSE file.
+
+#include "util/hash.h"
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <z3.h>
+
+namespace smt {
+
+/*
+ * Memoizes the answers of SMT queries. A query is keyed by a hash of its
+ * formula where the uninterpreted constants and functions are numbered in
+ * the order they first occur instead of being named, so the same query
+ * built for different functions (e.g., the same rewrite applied in different
+ * callers) gets the same key.
+ * Answers are kept in an LRU in memory shared by all threads and, optionally,
+ * in a directory with a file per query shared by all processes. Only SAT and
+ * UNSAT answers are stored, and SAT ones only if the model just gives values
+ * to constants.
+ */
+class QueryCache {
+public:
+  struct Query {
+    Hash128 key;
+    // uninterpreted constants and functions by order of first occurrence
+    std::vector<Z3_func_decl> vars;
+
+    Query(Z3_ast fml);
+  };
+
+  struct Answer {
+    bool sat = false;
+    float time = 0; // seconds the solver took
+    // constant index in Query::vars -> value in SMT-LIB syntax
+    std::vector<std::pair<unsigned, std::string>> model;
+
+    // Returns false if the model can't be stored
+    bool setModel(const Query &q, Z3_model m);
+    // Returns a referenced model of the calling thread's context
+    Z3_model getModel(const Query &q) const;
+
+    std::string serialize() const;
+    static std::optional<Answer> deserialize(std::string_view data);
+  };
+
+private:
+  std::string dir;
+  // most recently used first
+  std::list<std::pair<Hash128, Answer>> lru;
+  std::unordered_map<Hash128, decltype(lru)::iterator, Hash128::hasher> index;
+  std::mutex mutex;
+
+  void insert(const Hash128 &key, const Answer &answer);
+  std::string path(const Hash128 &key) const;
+
+public:
+  // dir may be empty to keep the answers in memory only
+  QueryCache(std::string dir);
+
+  std::optional<Answer> lookup(const Hash128 &key, bool &from_disk);
+  void store(const Hash128 &key, const Answer &answer);
+};
+
+}
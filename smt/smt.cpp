@@ -3,6 +3,7 @@
 
 #include "smt/smt.h"
 #include "smt/ctx.h"
+#include "smt/expr.h"
 #include "smt/solver.h"
 #include "util/version.h"
 #include <cstdint>
@@ -20,13 +21,13 @@ smt_initializer::smt_initializer() {
 
 void smt_initializer::reset() {
   destroy();
-  Z3_reset_memory();
+  context::reset_memory();
   init();
 }
 
 smt_initializer::~smt_initializer() {
   destroy();
-  Z3_finalize_memory();
+  context::finalize_memory();
 }
 
 void smt_initializer::init() {
@@ -36,6 +37,7 @@ void smt_initializer::init() {
 
 void smt_initializer::destroy() {
   solver_destroy();
+  expr_cache_clear();
   ctx.destroy();
 }
 
@@ -74,6 +76,10 @@ bool hit_half_memory_limit() {
   return Z3_get_estimated_alloc_size() >= (z3_memory_limit / 2);
 }
 
+bool hit_quarter_memory_limit() {
+  return Z3_get_estimated_alloc_size() >= (z3_memory_limit / 4);
+}
+
 void start_logging(const char *path) {
   Z3_open_log(path);
   string str = string("Alive2 ") + alive_version;
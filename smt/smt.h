@@ -27,6 +27,7 @@ const char *get_random_seed();
 void set_memory_limit(uint64_t limit);
 bool hit_memory_limit();
 bool hit_half_memory_limit();
+bool hit_quarter_memory_limit();
 
 void start_logging(const char *path = "z3_log.txt");
 
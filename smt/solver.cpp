@@ -2,16 +2,26 @@
 // Distributed under the MIT license that can be found in the LICENSE file.
 
 #include "smt/solver.h"
+#include "smt/backend.h"
 #include "smt/ctx.h"
+#include "smt/querycache.h"
+#include "smt/smt.h"
 #include "util/compiler.h"
 #include "util/config.h"
 #include "util/file.h"
+#include "util/stopwatch.h"
+#include <atomic>
 #include <cassert>
+#include <condition_variable>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string_view>
+#include <thread>
+#include <unistd.h>
 #include <utility>
 #include <vector>
 #include <z3.h>
@@ -23,14 +33,28 @@ using util::config::dbg;
 
 static bool tactic_verbose = false;
 
-static unsigned num_queries = 0;
-static unsigned num_skips = 0;
-static unsigned num_invalid = 0;
-static unsigned num_trivial = 0;
-static unsigned num_sats = 0;
-static unsigned num_unsats = 0;
-static unsigned num_timeout = 0;
-static unsigned num_errors = 0;
+// shared by all threads
+static atomic<unsigned> num_queries = 0;
+static atomic<unsigned> num_skips = 0;
+static atomic<unsigned> num_invalid = 0;
+static atomic<unsigned> num_trivial = 0;
+static atomic<unsigned> num_sats = 0;
+static atomic<unsigned> num_unsats = 0;
+static atomic<unsigned> num_timeout = 0;
+static atomic<unsigned> num_errors = 0;
+static atomic<unsigned> num_backend = 0;
+static atomic<unsigned> num_cache_hits = 0;
+static atomic<unsigned> num_cache_disk_hits = 0;
+static atomic<double> cache_saved_time = 0;
+
+static string backend_name = "z3";
+
+static constexpr unsigned max_portfolio = 8;
+static unsigned portfolio_size = 0;
+static atomic<unsigned> portfolio_wins[max_portfolio];
+
+// shared by all threads
+static optional<QueryCache> query_cache;
 
 namespace {
 
@@ -291,7 +315,217 @@ public:
 };
 }
 
-static optional<TopLevelTactic> tactic;
+// one per thread, as it belongs to the thread's context
+static thread_local optional<TopLevelTactic> tactic;
+
+
+namespace {
+
+// Name of each configuration of the portfolio. The first one is the
+// thread's own solver; the others run in helper threads.
+string portfolio_name(unsigned config) {
+  switch (config) {
+  case 0:  return "default";
+  case 1:  return "qfbv";
+  case 2:  return "smt";
+  default: return "seed" + to_string(config);
+  }
+}
+
+/*
+ * Runs a query with several solver configurations at once and takes the
+ * first definitive answer; the remaining ones are interrupted.
+ * Each helper thread has its own Z3 context, and the assertions of the query
+ * are translated into it before the helpers start. Helpers are idle outside
+ * check(), so their contexts are only touched by the owning thread then.
+ */
+class Portfolio {
+  struct Helper {
+    context ctx;
+    unsigned config;
+    Z3_solver s = nullptr;
+    Z3_lbool result = Z3_L_UNDEF;
+    bool running = false;
+    unique_ptr<thread> t;
+  };
+  vector<unique_ptr<Helper>> helpers;
+  // context of the thread that owns the portfolio
+  Z3_context main_ctx = ctx();
+
+  mutex m;
+  condition_variable cv_job, cv_done;
+  unsigned job = 0;
+  unsigned num_running = 0;
+  bool quit = false;
+  bool main_running = false;
+  // configuration with the first definitive answer, if any
+  optional<unsigned> winner;
+
+  void interruptOthers(unsigned config) {
+    if (config != 0 && main_running)
+      Z3_interrupt(main_ctx);
+    for (auto &h : helpers) {
+      if (h->config != config && h->running)
+        Z3_interrupt(h->ctx());
+    }
+  }
+
+  void run(Helper &h) {
+    unsigned seen = 0;
+    unique_lock lock(m);
+    while (true) {
+      cv_job.wait(lock, [&]() { return quit || job != seen; });
+      if (quit)
+        return;
+      seen = job;
+
+      lock.unlock();
+      auto r = Z3_solver_check(h.ctx(), h.s);
+      lock.lock();
+
+      h.result = r;
+      h.running = false;
+      if (r != Z3_L_UNDEF && !winner) {
+        winner = h.config;
+        interruptOthers(h.config);
+      }
+      --num_running;
+      cv_done.notify_all();
+    }
+  }
+
+  static Z3_solver mkSolver(Z3_context c, unsigned config) {
+    Z3_solver s;
+    if (config == 1)
+      s = Z3_mk_solver_for_logic(c, Z3_mk_string_symbol(c, "QF_BV"));
+    else if (config == 2)
+      s = Z3_mk_simple_solver(c);
+    else
+      s = Z3_mk_solver(c);
+    Z3_solver_inc_ref(c, s);
+
+    if (config >= 3) {
+      auto p = Z3_mk_params(c);
+      Z3_params_inc_ref(c, p);
+      Z3_params_set_uint(c, p, Z3_mk_string_symbol(c, "random_seed"),
+                         strtoul(get_random_seed(), nullptr, 10) + config);
+      Z3_solver_set_params(c, s, p);
+      Z3_params_dec_ref(c, p);
+    }
+    return s;
+  }
+
+public:
+  // process that started the helpers
+  const pid_t pid = getpid();
+
+  Portfolio(unsigned size) {
+    for (unsigned i = 1; i < size; ++i) {
+      auto &h = *helpers.emplace_back(make_unique<Helper>());
+      h.ctx.init();
+      h.config = i;
+      h.t = make_unique<thread>([this, &h]() { run(h); });
+    }
+  }
+
+  ~Portfolio() {
+    {
+      lock_guard lock(m);
+      quit = true;
+    }
+    cv_job.notify_all();
+    for (auto &h : helpers) {
+      h->t->join();
+      if (h->s)
+        Z3_solver_dec_ref(h->ctx(), h->s);
+      h->ctx.destroy();
+    }
+  }
+
+  // In a forked child the helper threads are gone, and the condition
+  // variables they were waiting on can't be destroyed. Free the contexts
+  // and leak the rest.
+  static void abandon(unique_ptr<Portfolio> &p) {
+    for (auto &h : p->helpers) {
+      (void)h->t.release();
+      h->ctx.destroy();
+    }
+    (void)p.release();
+  }
+
+  Z3_lbool check(Z3_solver s, Z3_model &model) {
+    auto fmls = Z3_solver_get_assertions(ctx(), s);
+    Z3_ast_vector_inc_ref(ctx(), fmls);
+    for (auto &h : helpers) {
+      if (h->s)
+        Z3_solver_dec_ref(h->ctx(), h->s);
+      h->s = mkSolver(h->ctx(), h->config);
+      for (unsigned i = 0, e = Z3_ast_vector_size(ctx(), fmls); i != e; ++i) {
+        Z3_solver_assert(h->ctx(), h->s,
+                         Z3_translate(ctx(), Z3_ast_vector_get(ctx(), fmls, i),
+                                      h->ctx()));
+      }
+    }
+    Z3_ast_vector_dec_ref(ctx(), fmls);
+
+    {
+      lock_guard lock(m);
+      winner.reset();
+      main_running = true;
+      num_running = helpers.size();
+      for (auto &h : helpers) {
+        h->running = true;
+      }
+      ++job;
+    }
+    cv_job.notify_all();
+
+    auto r = Z3_solver_check(ctx(), s);
+
+    unique_lock lock(m);
+    main_running = false;
+    if (r != Z3_L_UNDEF && !winner) {
+      winner = 0;
+      interruptOthers(0);
+    }
+    cv_done.wait(lock, [&]() { return num_running == 0; });
+
+    if (winner)
+      ++portfolio_wins[*winner];
+    if (!winner || *winner == 0)
+      return r;
+
+    auto &h = *helpers[*winner - 1];
+
+    // our check may have finished just before the winner interrupted it,
+    // which would cancel the next call; clear it with a trivial query
+    auto dummy = Z3_mk_simple_solver(ctx());
+    Z3_solver_inc_ref(ctx(), dummy);
+    Z3_solver_check(ctx(), dummy);
+    Z3_solver_dec_ref(ctx(), dummy);
+
+    if (h.result == Z3_L_TRUE) {
+      auto m = Z3_solver_get_model(h.ctx(), h.s);
+      Z3_model_inc_ref(h.ctx(), m);
+      model = Z3_model_translate(h.ctx(), m, ctx());
+      Z3_model_inc_ref(ctx(), model);
+      Z3_model_dec_ref(h.ctx(), m);
+    }
+    return h.result;
+  }
+
+  optional<unsigned> getWinner() const { return winner; }
+};
+}
+
+static thread_local unique_ptr<Portfolio> portfolio;
+static thread_local unique_ptr<Backend> backend;
+
+static void destroy_portfolio() {
+  if (portfolio && portfolio->pid != getpid())
+    Portfolio::abandon(portfolio);
+  portfolio.reset();
+}
 
 
 namespace smt {
@@ -404,6 +638,42 @@ void solver_tactic_verbose(bool yes) {
   tactic_verbose = yes;
 }
 
+void solver_portfolio(unsigned size) {
+  portfolio_size = min(size, max_portfolio);
+}
+
+void solver_query_cache(bool enable, const string &dir) {
+  if (enable || !dir.empty())
+    query_cache.emplace(dir);
+  else
+    query_cache.reset();
+}
+
+bool has_backend(const string &name) {
+  if (name == "z3")
+    return true;
+#ifndef NO_BITWUZLA_SUPPORT
+  if (name == "bitwuzla")
+    return true;
+#endif
+  return false;
+}
+
+unique_ptr<Backend> mk_backend(const string &name) {
+#ifndef NO_BITWUZLA_SUPPORT
+  if (name == "bitwuzla")
+    return mk_bitwuzla_backend();
+#endif
+  return nullptr;
+}
+
+bool solver_backend(const string &name) {
+  if (!has_backend(name))
+    return false;
+  backend_name = name;
+  return true;
+}
+
 Solver::Solver(bool simple) {
   s = simple ? Z3_mk_simple_solver(ctx())
              : tactic->getSolver();
@@ -415,6 +685,15 @@ Solver::~Solver() {
   tactic->reset_solver();
 }
 
+void Solver::setTimeout(unsigned ms) {
+  auto params = Z3_mk_params(ctx());
+  Z3_params_inc_ref(ctx(), params);
+  Z3_params_set_uint(ctx(), params, Z3_mk_string_symbol(ctx(), "timeout"),
+                     ms);
+  Z3_solver_set_params(ctx(), s, params);
+  Z3_params_dec_ref(ctx(), params);
+}
+
 void Solver::add(const expr &e) {
   if (e.isFalse()) {
     is_unsat = true;
@@ -467,7 +746,7 @@ expr Solver::assertions() const {
   return ret;
 }
 
-Result Solver::check() const {
+Result Solver::check(bool has_fallback) const {
   if (!valid) {
     ++num_invalid;
     return Result::INVALID;
@@ -506,21 +785,109 @@ Result Solver::check() const {
 
   tactic->check();
 
-  switch (Z3_solver_check(ctx(), s)) {
+  optional<QueryCache::Query> query;
+  if (query_cache) {
+    expr fml = assertions();
+    query.emplace(fml());
+    bool from_disk;
+    if (auto cached = query_cache->lookup(query->key, from_disk)) {
+      Z3_model m = nullptr;
+      if (cached->sat && (m = cached->getModel(*query))) {
+        // guard against hash collisions
+        Z3_ast val;
+        if (Z3_model_eval(ctx(), m, fml(), true, &val) &&
+            Z3_get_bool_value(ctx(), val) == Z3_L_FALSE) {
+          Z3_model_dec_ref(ctx(), m);
+          m = nullptr;
+        }
+      }
+      if (!cached->sat || m) {
+        ++num_cache_hits;
+        num_cache_disk_hits += from_disk;
+        cache_saved_time += cached->time;
+        if (print_queries)
+          dbg() << "Answered by the query cache" << endl;
+        if (!m) {
+          ++num_unsats;
+          return Result::UNSAT;
+        }
+        ++num_sats;
+        Result r(m);
+        Z3_model_dec_ref(ctx(), m);
+        return r;
+      }
+    }
+  }
+  StopWatch timer;
+
+  // helper threads don't survive a fork; start new ones in the child
+  if (portfolio && portfolio->pid != getpid()) {
+    destroy_portfolio();
+    portfolio = make_unique<Portfolio>(portfolio_size);
+  }
+
+  Backend::Answer ans;
+  optional<Backend::Answer> backend_ans;
+  if (backend)
+    backend_ans = backend->check(assertions()());
+
+  if (backend_ans) {
+    ans = std::move(*backend_ans);
+    ++num_backend;
+    if (print_queries)
+      dbg() << "Answered by " << backend->name() << endl;
+  } else if (portfolio) {
+    ans.result = portfolio->check(s, ans.model);
+    if (print_queries && portfolio->getWinner())
+      dbg() << "Answered by portfolio configuration "
+            << portfolio_name(*portfolio->getWinner()) << endl;
+  } else {
+    ans.result = Z3_solver_check(ctx(), s);
+  }
+
+  timer.stop();
+
+  switch (ans.result) {
   case Z3_L_FALSE:
     ++num_unsats;
+    if (query) {
+      QueryCache::Answer cached;
+      cached.time = timer.seconds();
+      query_cache->store(query->key, cached);
+    }
     return Result::UNSAT;
-  case Z3_L_TRUE:
+  case Z3_L_TRUE: {
     ++num_sats;
-    return Z3_solver_get_model(ctx(), s);
+    if (!ans.model) {
+      ans.model = Z3_solver_get_model(ctx(), s);
+      Z3_model_inc_ref(ctx(), ans.model);
+    }
+    if (query) {
+      QueryCache::Answer cached;
+      cached.sat  = true;
+      cached.time = timer.seconds();
+      if (cached.setModel(*query, ans.model))
+        query_cache->store(query->key, cached);
+    }
+    Result r(ans.model);
+    Z3_model_dec_ref(ctx(), ans.model);
+    return r;
+  }
   case Z3_L_UNDEF: {
-    string_view reason = Z3_solver_get_reason_unknown(ctx(), s);
-    if (reason == "timeout") {
+    if (ans.reason.empty())
+      ans.reason = Z3_solver_get_reason_unknown(ctx(), s);
+    if (has_fallback) {
+      --num_queries;
+      if (ans.reason == "timeout")
+        return Result::TIMEOUT;
+      return { Result::ERROR, std::move(ans.reason) };
+    }
+    if (ans.reason == "timeout") {
       ++num_timeout;
       return Result::TIMEOUT;
     }
     ++num_errors;
-    return { Result::ERROR, string(reason) };
+    return { Result::ERROR, std::move(ans.reason) };
   }
   default:
     UNREACHABLE();
@@ -564,6 +931,28 @@ void solver_print_stats(ostream &os) {
         "Num errors:  " << num_errors << " (" << error_pc << "%)\n"
         "Num SAT:     " << num_sats << " (" << sat_pc << "%)\n"
         "Num UNSAT:   " << num_unsats << " (" << unsat_pc << "%)\n";
+
+  if (backend_name != "z3") {
+    float backend_pc = num_queries == 0 ? 0 : num_backend / total;
+    os << "Num by " << backend_name << ": " << num_backend << " ("
+       << backend_pc << "%)\n";
+  }
+
+  if (portfolio_size > 1) {
+    os << "Portfolio wins:";
+    for (unsigned i = 0; i < portfolio_size; ++i) {
+      os << ' ' << portfolio_name(i) << '=' << portfolio_wins[i];
+    }
+    os << '\n';
+  }
+
+  if (query_cache) {
+    os << "Query cache hits: " << num_cache_hits << " ("
+       << num_cache_disk_hits << " from disk), saved "
+       << cache_saved_time << "s of solver time\n";
+  }
+
+  expr_cache_print_stats(os);
 }
 
 
@@ -596,9 +985,15 @@ void solver_init() {
                     "bit-blast", "simplify", "solve-eqs", "aig", "sat"}),
                    NamedTactic("smt"));
 #endif
+
+  if (portfolio_size > 1)
+    portfolio = make_unique<Portfolio>(portfolio_size);
+  backend = mk_backend(backend_name);
 }
 
 void solver_destroy() {
+  backend.reset();
+  destroy_portfolio();
   tactic.reset();
 }
 
@@ -155,6 +155,9 @@ public:
   Solver(bool simple = false);
   ~Solver();
 
+  // in ms, instead of the global query timeout
+  void setTimeout(unsigned ms);
+
   void add(const expr &e);
   // use a negated solver for minimization
   void block(const Model &m, Solver *sneg = nullptr);
@@ -162,7 +165,9 @@ public:
 
   expr assertions() const;
 
-  Result check() const;
+  // With a fallback, the caller checks the query again with another solver
+  // if this one doesn't answer, so the attempt isn't counted then
+  Result check(bool has_fallback = false) const;
 
   friend class SolverPush;
 };
@@ -181,6 +186,14 @@ public:
 
 void solver_print_queries(bool yes);
 void solver_tactic_verbose(bool yes);
+// Run each query with this many solver configurations in parallel threads
+// and take the first answer (0 or 1 disables it)
+void solver_portfolio(unsigned size);
+// Decide the queries in the logics it supports with this SMT solver, and
+// the others with Z3. Returns false if it's not compiled in.
+bool solver_backend(const std::string &name);
+// Memoize the answers of queries in memory and, if dir isn't empty, on disk
+void solver_query_cache(bool enable, const std::string &dir = {});
 void solver_print_stats(std::ostream &os);
 
 
@@ -0,0 +1,30 @@
+declare void @f(ptr %p)
+declare ptr @g()
+
+; %q may be %r, even though %p2 in between doesn't escape
+define i8 @src() {
+  %p1 = alloca i8
+  %p2 = alloca i8
+  %r = alloca i8
+  store i8 1, ptr %r
+  call void @f(ptr %p1)
+  call void @f(ptr %r)
+  %q = call ptr @g()
+  store i8 2, ptr %q
+  %v = load i8, ptr %r
+  ret i8 %v
+}
+
+define i8 @tgt() {
+  %p1 = alloca i8
+  %p2 = alloca i8
+  %r = alloca i8
+  store i8 1, ptr %r
+  call void @f(ptr %p1)
+  call void @f(ptr %r)
+  %q = call ptr @g()
+  store i8 2, ptr %q
+  ret i8 1
+}
+
+; ERROR: Value mismatch
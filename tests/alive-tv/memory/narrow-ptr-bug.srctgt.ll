@@ -0,0 +1,17 @@
+; TEST-ARGS: -narrow-ptr-bits=8
+; The bug found with 8-bit offsets also shows up at full width.
+
+define i8 @src(ptr %p) {
+  %q = getelementptr i8, ptr %p, i64 300
+  store i8 1, ptr %q
+  %v = load i8, ptr %q
+  ret i8 %v
+}
+
+define i8 @tgt(ptr %p) {
+  %q = getelementptr i8, ptr %p, i64 300
+  store i8 1, ptr %q
+  ret i8 2
+}
+
+; ERROR: Value mismatch
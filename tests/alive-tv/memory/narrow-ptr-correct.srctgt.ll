@@ -0,0 +1,18 @@
+; TEST-ARGS: -narrow-ptr-bits=8
+; The offset 300 needs 10 bits, so the 8-bit run is approximate and the
+; transformation is verified at full width.
+
+define i8 @src(ptr %p) {
+  %q = getelementptr i8, ptr %p, i64 300
+  store i8 1, ptr %q
+  %v = load i8, ptr %q
+  ret i8 %v
+}
+
+define i8 @tgt(ptr %p) {
+  %q = getelementptr i8, ptr %p, i64 300
+  store i8 1, ptr %q
+  ret i8 1
+}
+
+; CHECK: Transformation seems to be correct!
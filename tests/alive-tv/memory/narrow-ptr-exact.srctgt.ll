@@ -0,0 +1,33 @@
+; TEST-ARGS: -narrow-ptr-bits=10
+; The offset 300 needs 10 bits (the full width rounds it up to 12), so the
+; narrow run is final and the verdicts are the same as without the flag.
+
+define i8 @src_1(ptr %p) {
+  %q = getelementptr i8, ptr %p, i64 300
+  store i8 1, ptr %q
+  %v = load i8, ptr %q
+  ret i8 %v
+}
+
+define i8 @tgt_1(ptr %p) {
+  %q = getelementptr i8, ptr %p, i64 300
+  store i8 1, ptr %q
+  ret i8 1
+}
+
+define i8 @src_2(ptr %p) {
+  %q = getelementptr i8, ptr %p, i64 300
+  %v = load i8, ptr %q
+  ret i8 %v
+}
+
+define i8 @tgt_2(ptr %p) {
+  %q = getelementptr i8, ptr %p, i64 300
+  %v = load i8, ptr %q
+  %w = add i8 %v, 1
+  ret i8 %w
+}
+
+; CHECK: 1 correct transformations
+; CHECK: 1 incorrect transformations
+; CHECK: ERROR: Value mismatch
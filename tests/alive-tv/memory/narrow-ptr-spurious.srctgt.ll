@@ -0,0 +1,16 @@
+; TEST-ARGS: -narrow-ptr-bits=8
+; With 8-bit offsets, %p + 256 wraps around to %p. That bug doesn't show up
+; at full width and must not be reported.
+
+define i1 @src(ptr %p) {
+  %q = getelementptr i8, ptr %p, i64 256
+  %c = icmp eq ptr %q, %p
+  ret i1 %c
+}
+
+define i1 @tgt(ptr %p) {
+  ret i1 false
+}
+
+; CHECK: Transformation seems to be correct!
+; CHECK-NOT: ERROR:
@@ -0,0 +1,61 @@
+; TEST-ARGS: -batch=2
+; Pairs 1-2 and 3-4 share an SMT context. Each verdict must be the same as
+; when the pair is verified on its own.
+
+define i8 @src_1(i8 %x) {
+  %r = add i8 %x, 1
+  ret i8 %r
+}
+
+define i8 @tgt_1(i8 %x) {
+  %r = sub i8 %x, -1
+  ret i8 %r
+}
+
+; same src as above, in the same context
+define i8 @src_2(i8 %x) {
+  %r = add i8 %x, 1
+  ret i8 %r
+}
+
+define i8 @tgt_2(i8 %x) {
+  %r = add i8 %x, 2
+  ret i8 %r
+}
+
+define i8 @src_3() {
+  %p = alloca i8
+  store i8 1, ptr %p
+  %v = load i8, ptr %p
+  ret i8 %v
+}
+
+define i8 @tgt_3() {
+  ret i8 1
+}
+
+define i8 @src_4(i8 %x) {
+  ret i8 0
+}
+
+define i8 @tgt_4(i8 %x) {
+  %r = udiv i8 1, %x
+  ret i8 0
+}
+
+; starts a new context
+define i8 @src_5(i8 %x) {
+  %r = add i8 %x, 1
+  ret i8 %r
+}
+
+define i8 @tgt_5(i8 %x) {
+  %r = add nsw i8 %x, 1
+  ret i8 %r
+}
+
+; CHECK: 2 correct transformations
+; CHECK: 3 incorrect transformations
+; CHECK: ERROR: Value mismatch
+; CHECK: ERROR: Source is more defined than target
+; CHECK: ERROR: Target is more poisonous than source
@@ -0,0 +1,15 @@
+define <8 x i32> @src(<8 x i32> %v, <8 x i32> %s) {
+  %1 = call <8 x i32> @llvm.x86.avx2.psign.d(<8 x i32> %v, <8 x i32> %s)
+  ret <8 x i32> %1
+}
+
+define <8 x i32> @tgt(<8 x i32> %v, <8 x i32> %s) {
+  %zero = icmp eq <8 x i32> %s, zeroinitializer
+  %neg = icmp slt <8 x i32> %s, zeroinitializer
+  %negv = sub <8 x i32> zeroinitializer, %v
+  %1 = select <8 x i1> %neg, <8 x i32> %negv, <8 x i32> %v
+  %2 = select <8 x i1> %zero, <8 x i32> zeroinitializer, <8 x i32> %1
+  ret <8 x i32> %2
+}
+
+declare <8 x i32> @llvm.x86.avx2.psign.d(<8 x i32>, <8 x i32>)
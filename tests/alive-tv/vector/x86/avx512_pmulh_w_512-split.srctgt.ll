@@ -0,0 +1,17 @@
+; TEST-ARGS: -disable-undef-input -split-vector-lanes=4
+
+define <32 x i16> @src(<32 x i16> %a, <32 x i16> %b) {
+  %1 = call <32 x i16> @llvm.x86.avx512.pmulh.w.512(<32 x i16> %a, <32 x i16> %b)
+  ret <32 x i16> %1
+}
+
+define <32 x i16> @tgt(<32 x i16> %a, <32 x i16> %b) {
+  %ea = sext <32 x i16> %a to <32 x i32>
+  %eb = sext <32 x i16> %b to <32 x i32>
+  %m = mul <32 x i32> %ea, %eb
+  %s = lshr <32 x i32> %m, <i32 16, i32 16, i32 16, i32 16, i32 16, i32 16, i32 16, i32 16, i32 16, i32 16, i32 16, i32 16, i32 16, i32 16, i32 16, i32 16, i32 16, i32 16, i32 16, i32 16, i32 16, i32 16, i32 16, i32 16, i32 16, i32 16, i32 16, i32 16, i32 16, i32 16, i32 16, i32 16>
+  %1 = trunc <32 x i32> %s to <32 x i16>
+  ret <32 x i16> %1
+}
+
+declare <32 x i16> @llvm.x86.avx512.pmulh.w.512(<32 x i16>, <32 x i16>)
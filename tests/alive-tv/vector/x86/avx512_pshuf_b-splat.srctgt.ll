@@ -0,0 +1,20 @@
+; Shuffling a splat only zeroes the lanes with bit 7 of the index set.
+; Benchmark for the encoding of symbolic shuffle indices.
+; TEST-ARGS: -disable-undef-input
+
+define <64 x i8> @src(i8 %c, <64 x i8> %n) {
+  %ins = insertelement <64 x i8> poison, i8 %c, i32 0
+  %splat = shufflevector <64 x i8> %ins, <64 x i8> poison, <64 x i32> zeroinitializer
+  %1 = call <64 x i8> @llvm.x86.avx512.pshuf.b.512(<64 x i8> %splat, <64 x i8> %n)
+  ret <64 x i8> %1
+}
+
+define <64 x i8> @tgt(i8 %c, <64 x i8> %n) {
+  %ins = insertelement <64 x i8> poison, i8 %c, i32 0
+  %splat = shufflevector <64 x i8> %ins, <64 x i8> poison, <64 x i32> zeroinitializer
+  %neg = icmp slt <64 x i8> %n, zeroinitializer
+  %1 = select <64 x i1> %neg, <64 x i8> zeroinitializer, <64 x i8> %splat
+  ret <64 x i8> %1
+}
+
+declare <64 x i8> @llvm.x86.avx512.pshuf.b.512(<64 x i8>, <64 x i8>)
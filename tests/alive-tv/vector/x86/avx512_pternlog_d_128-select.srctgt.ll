@@ -0,0 +1,16 @@
+; Immediate 0xca is the bitwise select a ? b : c.
+
+define <4 x i32> @src(<4 x i32> %a, <4 x i32> %b, <4 x i32> %c) {
+  %1 = call <4 x i32> @llvm.x86.avx512.pternlog.d.128(<4 x i32> %a, <4 x i32> %b, <4 x i32> %c, i32 202)
+  ret <4 x i32> %1
+}
+
+define <4 x i32> @tgt(<4 x i32> %a, <4 x i32> %b, <4 x i32> %c) {
+  %ab = and <4 x i32> %a, %b
+  %na = xor <4 x i32> %a, <i32 -1, i32 -1, i32 -1, i32 -1>
+  %nac = and <4 x i32> %na, %c
+  %1 = or <4 x i32> %ab, %nac
+  ret <4 x i32> %1
+}
+
+declare <4 x i32> @llvm.x86.avx512.pternlog.d.128(<4 x i32>, <4 x i32>, <4 x i32>, i32)
@@ -0,0 +1,12 @@
+; TEST-ARGS: -disable-undef-input
+
+define <4 x i32> @src(<4 x i32> %c, <4 x i32> %a) {
+  %1 = call <4 x i32> @llvm.x86.avx512.vpdpbusds.128(<4 x i32> %c, <4 x i32> %a, <4 x i32> zeroinitializer)
+  ret <4 x i32> %1
+}
+
+define <4 x i32> @tgt(<4 x i32> %c, <4 x i32> %a) {
+  ret <4 x i32> %c
+}
+
+declare <4 x i32> @llvm.x86.avx512.vpdpbusds.128(<4 x i32>, <4 x i32>, <4 x i32>)
@@ -0,0 +1,14 @@
+; Selecting from two tables with constant indices is a plain shufflevector.
+; TEST-ARGS: -disable-undef-input -x86-shuffle-mux
+
+define <16 x i32> @src(<16 x i32> %a, <16 x i32> %b) {
+  %1 = call <16 x i32> @llvm.x86.avx512.vpermi2var.d.512(<16 x i32> %a, <16 x i32> <i32 0, i32 16, i32 1, i32 17, i32 2, i32 18, i32 3, i32 19, i32 36, i32 52, i32 37, i32 53, i32 38, i32 54, i32 -25, i32 -9>, <16 x i32> %b)
+  ret <16 x i32> %1
+}
+
+define <16 x i32> @tgt(<16 x i32> %a, <16 x i32> %b) {
+  %1 = shufflevector <16 x i32> %a, <16 x i32> %b, <16 x i32> <i32 0, i32 16, i32 1, i32 17, i32 2, i32 18, i32 3, i32 19, i32 4, i32 20, i32 5, i32 21, i32 6, i32 22, i32 7, i32 23>
+  ret <16 x i32> %1
+}
+
+declare <16 x i32> @llvm.x86.avx512.vpermi2var.d.512(<16 x i32>, <16 x i32>, <16 x i32>)
@@ -0,0 +1,10 @@
+define <4 x i32> @src() {
+  %1 = call <4 x i32> @llvm.x86.avx512.vpdpbusds.128(<4 x i32> <i32 2147483647, i32 0, i32 -2147483648, i32 10>, <4 x i32> <i32 -1, i32 16909060, i32 -1, i32 -2139062527>, <4 x i32> <i32 2139062143, i32 100400898, i32 -2139062144, i32 33685502>)
+  ret <4 x i32> %1
+}
+
+define <4 x i32> @tgt() {
+  ret <4 x i32> <i32 2147483647, i32 0, i32 -2147483648, i32 265>
+}
+
+declare <4 x i32> @llvm.x86.avx512.vpdpbusds.128(<4 x i32>, <4 x i32>, <4 x i32>)
@@ -0,0 +1,10 @@
+define <2 x i64> @src() {
+  %1 = call <2 x i64> @llvm.x86.avx512.vpmadd52h.uq.128(<2 x i64> <i64 1, i64 -1>, <2 x i64> <i64 4503599627370495, i64 320255973501901>, <2 x i64> <i64 4503599627370495, i64 4483583629026627>)
+  ret <2 x i64> %1
+}
+
+define <2 x i64> @tgt() {
+  ret <2 x i64> <i64 4503599627370495, i64 318832613619669>
+}
+
+declare <2 x i64> @llvm.x86.avx512.vpmadd52h.uq.128(<2 x i64>, <2 x i64>, <2 x i64>)
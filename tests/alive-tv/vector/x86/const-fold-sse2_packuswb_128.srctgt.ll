@@ -0,0 +1,10 @@
+define <16 x i8> @src() {
+  %1 = call <16 x i8> @llvm.x86.sse2.packuswb.128(<8 x i16> <i16 0, i16 127, i16 128, i16 -129, i16 -1, i16 300, i16 -300, i16 5>, <8 x i16> <i16 32767, i16 -32768, i16 1, i16 -1, i16 126, i16 -127, i16 0, i16 255>)
+  ret <16 x i8> %1
+}
+
+define <16 x i8> @tgt() {
+  ret <16 x i8> <i8 0, i8 127, i8 -128, i8 0, i8 0, i8 -1, i8 0, i8 5, i8 -1, i8 0, i8 1, i8 0, i8 126, i8 0, i8 0, i8 -1>
+}
+
+declare <16 x i8> @llvm.x86.sse2.packuswb.128(<8 x i16>, <8 x i16>)
@@ -0,0 +1,10 @@
+define <4 x i32> @src() {
+  %1 = call <4 x i32> @llvm.x86.sse2.pmadd.wd(<8 x i16> <i16 1, i16 -2, i16 300, i16 400, i16 -32768, i16 -32768, i16 7, i16 8>, <8 x i16> <i16 5, i16 6, i16 -7, i16 8, i16 -32768, i16 -32768, i16 100, i16 -100>)
+  ret <4 x i32> %1
+}
+
+define <4 x i32> @tgt() {
+  ret <4 x i32> <i32 -7, i32 1100, i32 -2147483648, i32 -100>
+}
+
+declare <4 x i32> @llvm.x86.sse2.pmadd.wd(<8 x i16>, <8 x i16>)
@@ -0,0 +1,10 @@
+define <2 x i64> @src() {
+  %1 = call <2 x i64> @llvm.x86.sse2.psad.bw(<16 x i8> <i8 0, i8 -1, i8 10, i8 20, i8 30, i8 40, i8 50, i8 60, i8 1, i8 2, i8 3, i8 4, i8 5, i8 6, i8 7, i8 8>, <16 x i8> <i8 -1, i8 0, i8 20, i8 10, i8 30, i8 50, i8 40, i8 70, i8 8, i8 7, i8 6, i8 5, i8 4, i8 3, i8 2, i8 1>)
+  ret <2 x i64> %1
+}
+
+define <2 x i64> @tgt() {
+  ret <2 x i64> <i64 560, i64 32>
+}
+
+declare <2 x i64> @llvm.x86.sse2.psad.bw(<16 x i8>, <16 x i8>)
@@ -0,0 +1,10 @@
+define <8 x i16> @src() {
+  %1 = call <8 x i16> @llvm.x86.ssse3.phadd.sw.128(<8 x i16> <i16 32767, i16 1, i16 -32768, i16 -1, i16 100, i16 200, i16 -5, i16 5>, <8 x i16> <i16 1, i16 2, i16 3, i16 4, i16 20000, i16 20000, i16 -20000, i16 -20000>)
+  ret <8 x i16> %1
+}
+
+define <8 x i16> @tgt() {
+  ret <8 x i16> <i16 32767, i16 -32768, i16 300, i16 0, i16 3, i16 7, i16 32767, i16 -32768>
+}
+
+declare <8 x i16> @llvm.x86.ssse3.phadd.sw.128(<8 x i16>, <8 x i16>)
@@ -0,0 +1,10 @@
+define <8 x i16> @src() {
+  %1 = call <8 x i16> @llvm.x86.ssse3.pmadd.ub.sw.128(<16 x i8> <i8 -1, i8 -1, i8 1, i8 2, i8 -128, i8 0, i8 10, i8 20, i8 -1, i8 -1, i8 0, i8 0, i8 3, i8 4, i8 5, i8 6>, <16 x i8> <i8 127, i8 127, i8 -128, i8 -128, i8 -1, i8 5, i8 3, i8 -4, i8 -128, i8 -128, i8 1, i8 1, i8 0, i8 0, i8 -1, i8 -1>)
+  ret <8 x i16> %1
+}
+
+define <8 x i16> @tgt() {
+  ret <8 x i16> <i16 32767, i16 -384, i16 -128, i16 -50, i16 -32768, i16 0, i16 0, i16 -11>
+}
+
+declare <8 x i16> @llvm.x86.ssse3.pmadd.ub.sw.128(<16 x i8>, <16 x i8>)
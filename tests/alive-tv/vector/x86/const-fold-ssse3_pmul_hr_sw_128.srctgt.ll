@@ -0,0 +1,10 @@
+define <8 x i16> @src() {
+  %1 = call <8 x i16> @llvm.x86.ssse3.pmul.hr.sw.128(<8 x i16> <i16 0, i16 1, i16 -1, i16 32767, i16 -32768, i16 16384, i16 -16384, i16 12345>, <8 x i16> <i16 0, i16 1, i16 -1, i16 32767, i16 -32768, i16 -32768, i16 16384, i16 -2345>)
+  ret <8 x i16> %1
+}
+
+define <8 x i16> @tgt() {
+  ret <8 x i16> <i16 0, i16 0, i16 0, i16 32766, i16 -32768, i16 -16384, i16 -8192, i16 -883>
+}
+
+declare <8 x i16> @llvm.x86.ssse3.pmul.hr.sw.128(<8 x i16>, <8 x i16>)
@@ -0,0 +1,10 @@
+define <16 x i8> @src() {
+  %1 = call <16 x i8> @llvm.x86.ssse3.pshuf.b.128(<16 x i8> <i8 16, i8 17, i8 18, i8 19, i8 20, i8 21, i8 22, i8 23, i8 24, i8 25, i8 26, i8 27, i8 28, i8 29, i8 30, i8 31>, <16 x i8> <i8 3, i8 -128, i8 15, i8 1, i8 -113, i8 2, i8 2, i8 7, i8 16, i8 31, i8 4, i8 -1, i8 9, i8 8, i8 0, i8 6>)
+  ret <16 x i8> %1
+}
+
+define <16 x i8> @tgt() {
+  ret <16 x i8> <i8 19, i8 0, i8 31, i8 17, i8 0, i8 18, i8 18, i8 23, i8 16, i8 31, i8 20, i8 0, i8 25, i8 24, i8 16, i8 22>
+}
+
+declare <16 x i8> @llvm.x86.ssse3.pshuf.b.128(<16 x i8>, <16 x i8>)
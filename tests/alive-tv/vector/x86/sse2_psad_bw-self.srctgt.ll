@@ -0,0 +1,12 @@
+; TEST-ARGS: -disable-undef-input
+
+define <2 x i64> @src(<16 x i8> %a) {
+  %1 = call <2 x i64> @llvm.x86.sse2.psad.bw(<16 x i8> %a, <16 x i8> %a)
+  ret <2 x i64> %1
+}
+
+define <2 x i64> @tgt(<16 x i8> %a) {
+  ret <2 x i64> zeroinitializer
+}
+
+declare <2 x i64> @llvm.x86.sse2.psad.bw(<16 x i8>, <16 x i8>)
@@ -0,0 +1,19 @@
+; TEST-ARGS: -disable-undef-input
+
+define <8 x i16> @src(<8 x i16> %a, <8 x i16> %b) {
+  %1 = call <8 x i16> @llvm.x86.ssse3.pmul.hr.sw.128(<8 x i16> %a, <8 x i16> %b)
+  ret <8 x i16> %1
+}
+
+define <8 x i16> @tgt(<8 x i16> %a, <8 x i16> %b) {
+  %ea = sext <8 x i16> %a to <8 x i32>
+  %eb = sext <8 x i16> %b to <8 x i32>
+  %m = mul <8 x i32> %ea, %eb
+  %s = lshr <8 x i32> %m, <i32 14, i32 14, i32 14, i32 14, i32 14, i32 14, i32 14, i32 14>
+  %r = add <8 x i32> %s, <i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1>
+  %h = lshr <8 x i32> %r, <i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1, i32 1>
+  %1 = trunc <8 x i32> %h to <8 x i16>
+  ret <8 x i16> %1
+}
+
+declare <8 x i16> @llvm.x86.ssse3.pmul.hr.sw.128(<8 x i16>, <8 x i16>)
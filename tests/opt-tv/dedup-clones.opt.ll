@@ -0,0 +1,35 @@
+; TEST-ARGS: -passes=sroa
+; CHECK: Skipping repeated query
+; CHECK-NOT: ERROR
+
+; @g is @f with other names and the blocks in another order; it's only
+; verified once
+
+define i32 @f(i1 %cond) {
+  %p = alloca i32
+  br i1 %cond, label %A, label %B
+A:
+  store i32 1, ptr %p
+  br label %EXIT
+B:
+  store i32 2, ptr %p
+  br label %EXIT
+EXIT:
+  %v = load i32, ptr %p
+  ret i32 %v
+}
+
+define i32 @g(i1 %c) {
+entry:
+  %mem = alloca i32
+  br i1 %c, label %then, label %else
+join:
+  %r = load i32, ptr %mem
+  ret i32 %r
+then:
+  store i32 1, ptr %mem
+  br label %join
+else:
+  store i32 2, ptr %mem
+  br label %join
+}
@@ -0,0 +1,155 @@
+// Copyright (c) 2018-present The Alive2 Authors.
+// Distributed under the MIT license that can be found in the LICENSE file.
+
+// Measures the cost of the memory model on memcpy- and load-heavy functions.
+// For each number of pointer inputs N it verifies a function against itself;
+// the function copies a byte along the chain of its pointer inputs
+// (p0 -> p1 -> ... -> pN-1) and then loads and xors all of them. Every
+// pointer may alias the others, so the alias sets span all the N blocks.
+
+#include "ir/constant.h"
+#include "ir/function.h"
+#include "ir/instr.h"
+#include "ir/type.h"
+#include "smt/smt.h"
+#include "tools/transform.h"
+#include "util/config.h"
+#include "util/stopwatch.h"
+#include "util/version.h"
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string_view>
+#include <vector>
+
+using namespace IR;
+using namespace tools;
+using namespace util;
+using namespace std;
+
+namespace {
+
+void build(Function &f, IntType &i8, IntType &i64, PtrType &ptr,
+           unsigned n) {
+  f.setType(i8);
+  f.getFnAttrs().mem.setFullAccess();
+
+  vector<Value*> ptrs;
+  for (unsigned i = 0; i != n; ++i) {
+    auto input = make_unique<Input>(ptr, "%p" + to_string(i));
+    ptrs.emplace_back(input.get());
+    f.addInput(std::move(input));
+  }
+
+  auto one = make_unique<IntConst>(i64, 1);
+  auto &bytes = *one;
+  f.addConstant(std::move(one));
+
+  auto &bb = f.getBB("entry");
+  for (unsigned i = 1; i != n; ++i) {
+    bb.addInstr(make_unique<Memcpy>(*ptrs[i], *ptrs[i-1], bytes, 1, 1,
+                                    false));
+  }
+
+  Value *acc = nullptr;
+  for (unsigned i = 0; i != n; ++i) {
+    auto load = make_unique<Load>(i8, "%v" + to_string(i), *ptrs[i], 1);
+    Value *v = load.get();
+    bb.addInstr(std::move(load));
+    if (acc) {
+      auto x = make_unique<BinOp>(i8, "%x" + to_string(i), *acc, *v,
+                                  BinOp::Xor);
+      v = x.get();
+      bb.addInstr(std::move(x));
+    }
+    acc = v;
+  }
+  bb.addInstr(make_unique<Return>(i8, *acc));
+}
+
+// vcgen is the time to encode the functions (where the alias sets are
+// computed); time is that of the whole verification, which encodes them again
+string verify(unsigned n, float &vcgen, float &time) {
+  IntType i8("i8", 8), i64("i64", 64);
+  PtrType ptr(0);
+  Transform t;
+  build(t.src, i8, i64, ptr, n);
+  build(t.tgt, i8, i64, ptr, n);
+  t.preprocess();
+
+  TransformVerify tv(t, false);
+  auto typings = tv.getTypings();
+  if (!typings)
+    return "Doesn't type check";
+  tv.fixupTypes(typings);
+
+  StopWatch sw_vcgen;
+  tv.exec();
+  sw_vcgen.stop();
+  vcgen = sw_vcgen.seconds();
+
+  StopWatch sw;
+  auto errs = tv.verify();
+  sw.stop();
+  time = sw.seconds();
+
+  if (!errs)
+    return "ok";
+
+  stringstream ss;
+  ss << errs;
+  string msg;
+  getline(ss, msg);
+  return msg.compare(0, 7, "ERROR: ") == 0 ? msg.substr(7) : msg;
+}
+
+void show_help() {
+  cerr << "Usage: alive-mem-bench <options>\n"
+          "version "
+       << alive_version
+       << "\n\n"
+          "Options:\n"
+          " -ptrs:x\t\tLargest number of pointer inputs (default 64)\n"
+          " -smt-to:x\t\tTimeout for SMT queries in ms\n"
+          " -h / --help / -v / --version\tShow this help\n";
+}
+
+}
+
+int main(int argc, char **argv) {
+  unsigned max_ptrs = 64;
+
+  for (int argc_i = 1; argc_i < argc; ++argc_i) {
+    string_view arg(argv[argc_i]);
+    if (arg.compare(0, 6, "-ptrs:") == 0 && arg.size() > 6)
+      max_ptrs = strtoul(arg.substr(6).data(), nullptr, 10);
+    else if (arg.compare(0, 8, "-smt-to:") == 0 && arg.size() > 8)
+      smt::set_query_timeout(arg.substr(8).data());
+    else if (arg == "-h" || arg == "--help" || arg == "-v" ||
+             arg == "--version") {
+      show_help();
+      return 0;
+    } else {
+      cerr << "Unknown argument: " << arg << "\n\n";
+      show_help();
+      return -1;
+    }
+  }
+
+  config::disable_undef_input = true;
+  smt::smt_initializer smt_init;
+
+  cout << "ptrs\tvcgen_ms\ttime_ms\tresult\n";
+  float total_vcgen = 0, total = 0;
+  for (unsigned n = 2; n <= max_ptrs; n *= 2) {
+    float vcgen = 0, time = 0;
+    auto result = verify(n, vcgen, time);
+    total_vcgen += vcgen;
+    total += time;
+    cout << n << '\t' << (unsigned)(vcgen * 1000) << '\t'
+         << (unsigned)(time * 1000) << '\t' << result << endl;
+  }
+  cout << "total\t" << (unsigned)(total_vcgen * 1000) << '\t'
+       << (unsigned)(total * 1000) << '\n';
+}
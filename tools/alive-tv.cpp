@@ -8,6 +8,7 @@
 #include "llvm_util/utils.h"
 #include "smt/smt.h"
 #include "tools/transform.h"
+#include "util/stopwatch.h"
 #include "util/version.h"
 
 #include "llvm/Analysis/TargetLibraryInfo.h"
@@ -67,6 +68,15 @@ llvm::cl::opt<string>
                            "https://llvm.org/docs/NewPassManager.html#invoking-opt"),
             llvm::cl::cat(alive_cmdargs), llvm::cl::init("O2"));
 
+llvm::cl::opt<unsigned> opt_batch(LLVM_ARGS_PREFIX "batch",
+  llvm::cl::desc("Number of function pairs verified with the same SMT context "
+                 "before resetting it (0 = only when low on memory; "
+                 "default=1)"),
+  llvm::cl::cat(alive_cmdargs), llvm::cl::init(1));
+
+llvm::cl::opt<bool> opt_throughput(LLVM_ARGS_PREFIX "throughput",
+  llvm::cl::desc("Report the number of function pairs verified per second"),
+  llvm::cl::cat(alive_cmdargs), llvm::cl::init(false));
 
 }
 
@@ -137,6 +147,8 @@ and "tgt5" will unused.
   verifier.always_verify = opt_always_verify;
   verifier.print_dot = opt_print_dot;
   verifier.bidirectional = opt_bidirectional;
+  verifier.batch_size = opt_batch;
+  StopWatch sw;
 
   unique_ptr<llvm::Module> M2;
   if (opt_file2.empty()) {
@@ -233,6 +245,15 @@ summary:
           "  " << verifier.num_errors << " Alive2 errors\n";
 
 end:
+  if (opt_throughput) {
+    sw.stop();
+    unsigned num = verifier.num_correct + verifier.num_unsound +
+                   verifier.num_failed + verifier.num_errors;
+    float secs = sw.seconds();
+    *out << "Throughput: " << num << " function pairs in " << secs << " s ("
+         << (secs > 0 ? num / secs : 0) << " functions/s)\n";
+  }
+
   if (opt_smt_stats)
     smt::solver_print_stats(*out);
 
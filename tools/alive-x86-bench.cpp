@@ -0,0 +1,437 @@
+// Copyright (c) 2018-present The Alive2 Authors.
+// Distributed under the MIT license that can be found in the LICENSE file.
+
+// Measures how expensive each x86 intrinsic is for the SMT solver. For each
+// entry of the intrinsics tables it verifies two canonical transformations:
+//  - id:   tgt is the same call as src; the refinement holds.
+//  - near: tgt flips the lowest bit of lane 0 of the first operand; this
+//          usually gives a counterexample.
+// It reports the size of the encoding, the verification time, the peak
+// memory and the result of each one, and compares them against a baseline.
+
+#include "ir/constant.h"
+#include "ir/function.h"
+#include "ir/instr.h"
+#include "ir/type.h"
+#include "ir/x86_intrinsics.h"
+#include "smt/expr.h"
+#include "smt/smt.h"
+#include "smt/solver.h"
+#include "tools/transform.h"
+#include "util/config.h"
+#include "util/stopwatch.h"
+#include "util/version.h"
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string_view>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <unordered_set>
+#include <vector>
+
+using namespace IR;
+using namespace smt;
+using namespace tools;
+using namespace util;
+using namespace std;
+
+namespace {
+
+using Shape = pair<unsigned, unsigned>;
+
+struct Intrinsic {
+  string name;
+  Shape ret;
+  vector<Shape> args;
+  function<unique_ptr<Instr>(Type&, const vector<Value*>&)> mk;
+  function<StateValue(const vector<StateValue>&)> encode;
+};
+
+template <typename I, unsigned N>
+void add_intrinsics(vector<Intrinsic> &v) {
+  for (unsigned i = 0; i != I::numOfX86Intrinsics; ++i) {
+    auto op = (typename I::Op)i;
+    auto &in = v.emplace_back();
+    in.name = I::getOpName(op);
+    in.ret  = I::shape_ret[i];
+    in.args = { I::shape_op0[i], I::shape_op1[i] };
+    if constexpr (N >= 3)
+      in.args.emplace_back(I::shape_op2[i]);
+    if constexpr (N >= 4)
+      in.args.emplace_back(I::shape_op3[i]);
+
+    in.mk = [op](Type &ty, const vector<Value*> &a) -> unique_ptr<Instr> {
+      if constexpr (N == 2)
+        return make_unique<I>(ty, "%r", *a[0], *a[1], op);
+      else if constexpr (N == 3)
+        return make_unique<I>(ty, "%r", *a[0], *a[1], *a[2], op);
+      else
+        return make_unique<I>(ty, "%r", *a[0], *a[1], *a[2], *a[3], op);
+    };
+    in.encode = [op](const vector<StateValue> &a) {
+      if constexpr (N == 2)
+        return x86_encode(op, a[0], a[1]);
+      else if constexpr (N == 3)
+        return x86_encode(op, a[0], a[1], a[2]);
+      else
+        return x86_encode(op, a[0], a[1], a[2], a[3]);
+    };
+  }
+}
+
+class Types {
+  map<Shape, unique_ptr<Type>> types;
+
+public:
+  Type& get(Shape shape) {
+    auto &ty = types[shape];
+    if (!ty) {
+      ostringstream name;
+      if (shape.first == 1) {
+        name << 'i' << shape.second;
+        ty = make_unique<IntType>(std::move(name).str(), shape.second);
+      } else {
+        name << 'v' << shape.first << 'i' << shape.second;
+        ty = make_unique<VectorType>(std::move(name).str(), shape.first,
+                                     get({1, shape.second}));
+      }
+    }
+    return *ty;
+  }
+};
+
+void build(Function &f, Types &types, const Intrinsic &in, bool near) {
+  auto &ret_ty = types.get(in.ret);
+  f.setType(ret_ty);
+
+  vector<Value*> args;
+  for (unsigned i = 0; i != in.args.size(); ++i) {
+    string name = "%";
+    name += char('a' + i);
+    auto input = make_unique<Input>(types.get(in.args[i]), std::move(name));
+    args.emplace_back(input.get());
+    f.addInput(std::move(input));
+  }
+
+  auto &bb = f.getBB("entry");
+  if (near) {
+    auto shape = in.args[0];
+    auto &ty = types.get(shape);
+    auto &elem_ty = types.get({1, shape.second});
+
+    auto one = make_unique<IntConst>(elem_ty, 1);
+    Value *mask = one.get();
+    f.addConstant(std::move(one));
+    if (shape.first != 1) {
+      auto zero = make_unique<IntConst>(elem_ty, 0);
+      vector<Value*> vals(shape.first, zero.get());
+      vals[0] = mask;
+      f.addConstant(std::move(zero));
+      auto agg = make_unique<AggregateValue>(ty, std::move(vals));
+      mask = agg.get();
+      f.addConstant(std::move(agg));
+    }
+
+    auto x = make_unique<BinOp>(ty, "%x", *args[0], *mask, BinOp::Xor);
+    args[0] = x.get();
+    bb.addInstr(std::move(x));
+  }
+
+  auto r = in.mk(ret_ty, args);
+  auto &rv = *r;
+  bb.addInstr(std::move(r));
+  bb.addInstr(make_unique<Return>(ret_ty, rv));
+}
+
+// number of distinct terms of the encoding over fresh variables
+unsigned count_terms(const Intrinsic &in) {
+  vector<StateValue> args;
+  for (unsigned i = 0; i != in.args.size(); ++i) {
+    auto [lanes, bits] = in.args[i];
+    string name = "arg" + to_string(i);
+    auto np = name + "_np";
+    args.push_back({ expr::mkVar(name.c_str(), lanes * bits),
+                     lanes == 1 ? expr::mkBoolVar(np.c_str())
+                                : expr::mkVar(np.c_str(), lanes) });
+  }
+  auto r = in.encode(args);
+
+  unordered_set<unsigned> seen;
+  vector<expr> todo = { std::move(r.value), std::move(r.non_poison) };
+  while (!todo.empty()) {
+    expr e = std::move(todo.back());
+    todo.pop_back();
+    if (!seen.emplace(e.id()).second || e.fn_name().empty())
+      continue;
+    for (unsigned i = 0, n = e.getFnNumArgs(); i != n; ++i) {
+      todo.emplace_back(e.getFnArg(i));
+    }
+  }
+  return seen.size();
+}
+
+struct Row {
+  unsigned terms = 0;
+  float time = 0;   // seconds
+  long mem = 0;     // KB
+  string result;
+};
+
+string verify(const Intrinsic &in, bool near, float &time) {
+  Types types;
+  Transform t;
+  build(t.src, types, in, false);
+  build(t.tgt, types, in, near);
+  t.preprocess();
+
+  TransformVerify tv(t, false);
+  auto typings = tv.getTypings();
+  if (!typings)
+    return "Doesn't type check";
+  tv.fixupTypes(typings);
+
+  StopWatch sw;
+  auto errs = tv.verify();
+  sw.stop();
+  time = sw.seconds();
+
+  if (!errs)
+    return "ok";
+
+  stringstream ss;
+  ss << errs;
+  string msg;
+  getline(ss, msg);
+  return msg.compare(0, 7, "ERROR: ") == 0 ? msg.substr(7) : msg;
+}
+
+// Runs the benchmark in a child process, so that each one gets a fresh
+// solver and its own peak memory usage. The child starts with the memory
+// of the harness already resident; that part is not counted.
+Row run(const Intrinsic &in, bool near) {
+  Row row;
+  int fd[2];
+  if (pipe(fd) < 0) {
+    row.result = "pipe failed";
+    return row;
+  }
+
+  cout.flush();
+  pid_t pid = fork();
+  if (pid == 0) {
+    close(fd[0]);
+    struct rusage start {};
+    getrusage(RUSAGE_SELF, &start);
+    Row r;
+    r.terms = count_terms(in);
+    r.result = verify(in, near, r.time);
+    auto msg = to_string(start.ru_maxrss) + '\t' + to_string(r.terms) + '\t' +
+               to_string(r.time) + '\t' + r.result;
+    ssize_t ret = write(fd[1], msg.data(), msg.size());
+    _exit(ret == (ssize_t)msg.size() ? 0 : 1);
+  }
+  close(fd[1]);
+
+  string msg;
+  char buf[512];
+  ssize_t n;
+  while (pid > 0 && (n = read(fd[0], buf, sizeof(buf))) > 0) {
+    msg.append(buf, n);
+  }
+  close(fd[0]);
+
+  int status = 0;
+  struct rusage usage {};
+  if (pid < 0 || wait4(pid, &status, 0, &usage) < 0) {
+    row.result = "fork failed";
+    return row;
+  }
+  long start_mem = 0;
+  istringstream is(msg);
+  if (!(is >> start_mem >> row.terms >> row.time) ||
+      !getline(is >> ws, row.result))
+    row.result = "crashed";
+  row.mem = max(usage.ru_maxrss - start_mem, 0l);
+  return row;
+}
+
+using Report = map<pair<string, string>, Row>;
+
+void print_header(ostream &os) {
+  os << "op\tpair\tterms\ttime_ms\tmem_kb\tresult\n";
+}
+
+void print_row(ostream &os, const string &op, const string &pair,
+               const Row &r) {
+  os << op << '\t' << pair << '\t' << r.terms << '\t'
+     << (unsigned)(r.time * 1000) << '\t' << r.mem << '\t' << r.result
+     << '\n';
+}
+
+bool read_report(const char *file, Report &report) {
+  ifstream f(file);
+  if (!f)
+    return false;
+
+  string line;
+  getline(f, line); // header
+  while (getline(f, line)) {
+    istringstream is(line);
+    string op, pair;
+    Row r;
+    unsigned time_ms;
+    if (!getline(is, op, '\t') || !getline(is, pair, '\t') ||
+        !(is >> r.terms >> time_ms >> r.mem) ||
+        !getline(is >> ws, r.result))
+      return false;
+    r.time = time_ms / 1000.0;
+    report[{ std::move(op), std::move(pair) }] = std::move(r);
+  }
+  return true;
+}
+
+void show_help() {
+  cerr << "Usage: alive-x86-bench <options>\n"
+          "version "
+       << alive_version
+       << "\n\n"
+          "Options:\n"
+          " -ops:x\t\t\tOnly run the intrinsics whose name contains x\n"
+          " -o:file\t\tWrite the report to file instead of stdout\n"
+          " -baseline:file\t\tCompare against a previous report\n"
+          " -time-slack:x\t\tAllowed time increase factor (default 2)\n"
+          " -smt-to:x\t\tTimeout for SMT queries in ms\n"
+          " -smt-portfolio:x\tRun SMT queries with x solver configurations\n"
+          " -smt-backend:x\t\tSMT solver for the queries in its logic\n"
+          " -smt-query-cache\tMemoize the answers of SMT queries\n"
+          " -smt-query-cache-dir:x\tAlso store the answers in directory x\n"
+          " -max-mem:x\t\tMax memory consumption in MB (approx)\n"
+          " -x86-shuffle-mux\tEncode variable shuffles with mux trees\n"
+          " -h / --help / -v / --version\tShow this help\n";
+}
+
+}
+
+int main(int argc, char **argv) {
+  string_view filter;
+  const char *out_file = nullptr;
+  const char *baseline_file = nullptr;
+  float time_slack = 2;
+
+  for (int argc_i = 1; argc_i < argc; ++argc_i) {
+    string_view arg(argv[argc_i]);
+    if (arg.compare(0, 5, "-ops:") == 0)
+      filter = arg.substr(5);
+    else if (arg.compare(0, 3, "-o:") == 0 && arg.size() > 3)
+      out_file = arg.substr(3).data();
+    else if (arg.compare(0, 10, "-baseline:") == 0 && arg.size() > 10)
+      baseline_file = arg.substr(10).data();
+    else if (arg.compare(0, 12, "-time-slack:") == 0 && arg.size() > 12)
+      time_slack = strtof(arg.substr(12).data(), nullptr);
+    else if (arg.compare(0, 8, "-smt-to:") == 0 && arg.size() > 8)
+      smt::set_query_timeout(arg.substr(8).data());
+    else if (arg.compare(0, 15, "-smt-portfolio:") == 0 && arg.size() > 15)
+      smt::solver_portfolio(strtoul(arg.substr(15).data(), nullptr, 10));
+    else if (arg.compare(0, 13, "-smt-backend:") == 0 && arg.size() > 13) {
+      if (!smt::solver_backend(string(arg.substr(13)))) {
+        cerr << "SMT backend " << arg.substr(13) << " not compiled in!\n";
+        return -1;
+      }
+    }
+    else if (arg == "-smt-query-cache")
+      smt::solver_query_cache(true);
+    else if (arg.compare(0, 21, "-smt-query-cache-dir:") == 0 &&
+             arg.size() > 21)
+      smt::solver_query_cache(true, string(arg.substr(21)));
+    else if (arg.compare(0, 9, "-max-mem:") == 0 && arg.size() > 9)
+      smt::set_memory_limit(strtoul(arg.substr(9).data(), nullptr, 10) *
+                            1024 * 1024);
+    else if (arg == "-x86-shuffle-mux")
+      config::x86_shuffle_mux = true;
+    else if (arg == "-h" || arg == "--help" || arg == "-v" ||
+             arg == "--version") {
+      show_help();
+      return 0;
+    } else {
+      cerr << "Unknown argument: " << arg << "\n\n";
+      show_help();
+      return -1;
+    }
+  }
+
+  Report baseline;
+  if (baseline_file && !read_report(baseline_file, baseline)) {
+    cerr << "Couldn't read the baseline " << baseline_file << '\n';
+    return -2;
+  }
+
+  ofstream of;
+  if (out_file) {
+    of.open(out_file);
+    if (!of) {
+      cerr << "Couldn't open " << out_file << '\n';
+      return -2;
+    }
+  }
+  ostream &out = out_file ? of : cout;
+
+  // inputs are never undef, as otherwise the query is quantified and the
+  // cost is dominated by the instantiation of undef
+  config::disable_undef_input = true;
+  smt::smt_initializer smt_init;
+
+  vector<Intrinsic> intrinsics;
+  add_intrinsics<X86IntrinBinOp, 2>(intrinsics);
+  add_intrinsics<X86IntrinTerOp, 3>(intrinsics);
+  add_intrinsics<X86IntrinQuadOp, 4>(intrinsics);
+
+  print_header(out);
+  unsigned regressions = 0;
+
+  for (auto &in : intrinsics) {
+    if (in.name.find(filter) == string::npos)
+      continue;
+
+    for (auto *pair : { "id", "near" }) {
+      auto row = run(in, pair[0] == 'n');
+      print_row(out, in.name, pair, row);
+      out.flush();
+
+      auto I = baseline.find({ in.name, pair });
+      if (I == baseline.end())
+        continue;
+
+      auto &base = I->second;
+      string why;
+      if (row.result != base.result)
+        why = "result was '" + base.result + "', now '" + row.result + "'";
+      else if (row.terms > base.terms + base.terms / 10)
+        why = "terms went from " + to_string(base.terms) + " to " +
+              to_string(row.terms);
+      // ignore noise on quick queries
+      else if (row.time > base.time * time_slack + 0.1)
+        why = "time went from " + to_string(base.time) + "s to " +
+              to_string(row.time) + 's';
+      // and on small footprints
+      else if (row.mem > base.mem + base.mem / 10 + 1024)
+        why = "memory went from " + to_string(base.mem) + "KB to " +
+              to_string(row.mem) + "KB";
+
+      if (!why.empty()) {
+        cerr << "REGRESSION: " << in.name << ' ' << pair << ": " << why
+             << '\n';
+        ++regressions;
+      }
+    }
+  }
+
+  if (baseline_file)
+    cerr << regressions << " regression(s) against " << baseline_file << '\n';
+  return regressions != 0;
+}
@@ -29,6 +29,10 @@ static void show_help() {
           " -smt-stats\t\tShow SMT statistics\n"
           " -smt-to:x\t\tTimeout for SMT queries in ms\n"
           " -smt-random-seed:x\tRandom seed for the SMT solver\n"
+          " -smt-portfolio:x\tRun SMT queries with x solver configurations\n"
+          " -smt-backend:x\t\tSMT solver for the queries in its logic\n"
+          " -smt-query-cache\tMemoize the answers of SMT queries\n"
+          " -smt-query-cache-dir:x\tAlso store the answers in directory x\n"
           " -max-mem:x\t\tMax memory consumption in MB (approx)\n"
           " -smt-verbose\t\tPrint all SMT queries\n"
           " -tactic-verbose\tDebug SMT tactics\n"
@@ -61,6 +65,19 @@ int main(int argc, char **argv) {
       smt::set_query_timeout(arg.substr(8).data());
     else if (arg.compare(0, 17, "-smt-random-seed:") == 0 && arg.size() > 17)
       smt::set_random_seed(arg.substr(17).data());
+    else if (arg.compare(0, 15, "-smt-portfolio:") == 0 && arg.size() > 15)
+      smt::solver_portfolio(strtoul(arg.substr(15).data(), nullptr, 10));
+    else if (arg.compare(0, 13, "-smt-backend:") == 0 && arg.size() > 13) {
+      if (!smt::solver_backend(string(arg.substr(13)))) {
+        cerr << "SMT backend " << arg.substr(13) << " not compiled in!\n";
+        return -1;
+      }
+    }
+    else if (arg == "-smt-query-cache")
+      smt::solver_query_cache(true);
+    else if (arg.compare(0, 21, "-smt-query-cache-dir:") == 0 &&
+             arg.size() > 21)
+      smt::solver_query_cache(true, string(arg.substr(21)));
     else if (arg.compare(0, 9, "-max-mem:") == 0 && arg.size() > 9)
       smt::set_memory_limit(strtoul(arg.substr(9).data(), nullptr, 10) *
                             1024 * 1024);
@@ -4,9 +4,11 @@
 #include "tools/transform.h"
 #include "ir/globals.h"
 #include "ir/state.h"
+#include "ir/x86_intrinsics.h"
 #include "smt/expr.h"
 #include "smt/smt.h"
 #include "smt/solver.h"
+#include "util/compiler.h"
 #include "util/config.h"
 #include "util/dataflow.h"
 #include "util/errors.h"
@@ -14,12 +16,18 @@
 #include "util/symexec.h"
 #include <algorithm>
 #include <bit>
+#include <cctype>
 #include <climits>
+#include <functional>
 #include <iostream>
 #include <map>
 #include <numeric>
+#include <poll.h>
 #include <set>
+#include <signal.h>
 #include <sstream>
+#include <sys/wait.h>
+#include <unistd.h>
 #include <unordered_map>
 
 using namespace IR;
@@ -102,7 +110,7 @@ using print_var_val_ty = function<void(ostream&, const Model&)>;
 static bool error(Errors &errs, State &src_state, State &tgt_state,
                   const Result &r, Solver &solver, const Value *var,
                   const char *msg, bool check_each_var,
-                  print_var_val_ty print_var_val) {
+                  print_var_val_ty print_var_val, expr *cex_inputs) {
 
   if (r.isInvalid()) {
     errs.add("Invalid expr", false);
@@ -229,6 +237,22 @@ static bool error(Errors &errs, State &src_state, State &tgt_state,
     s << '\n';
   }
 
+  // Record the values of the non-pointer inputs so that the counterexample
+  // can be replayed with different pointer widths
+  if (cex_inputs) {
+    expr pin = true;
+    for (auto &var : src_state.getFn().getInputs()) {
+      if (hasPtr(var.getType()))
+        continue;
+      auto &val = src_state.at(var)->val;
+      for (auto *e : { &val.value, &val.non_poison }) {
+        if (e->isVar())
+          pin &= *e == m[*e];
+      }
+    }
+    *cex_inputs = std::move(pin);
+  }
+
   set<string> seen_vars;
   for (auto st : { &src_state, &tgt_state }) {
     if (!check_each_var) {
@@ -473,11 +497,143 @@ static expr encode_undef_refinement(const State &src_state,
                                           subst(tgt_state, b));
 }
 
+// Returns the number of lanes of the vector type in which the refinement
+// query of src and tgt can be split, or 0 if they are not lane-separable.
+// Splitting is sound regardless, as the negated refinement is a disjunction
+// over the lanes; this only checks whether each chunk of lanes depends on a
+// small part of the inputs so that the subqueries are actually easier.
+static unsigned lane_chunk(const Transform &t, const Type &type) {
+  auto aty = type.getAsAggregateType();
+  if (!type.isVectorType() || !aty)
+    return 0;
+
+  unsigned elem_bits = aty->getChild(0).bits();
+  unsigned chunk_bits = elem_bits;
+
+  for (auto *fn : { &t.src, &t.tgt }) {
+    for (auto &i : fn->instrs()) {
+      unsigned bits;
+      if (auto op = dynamic_cast<const X86IntrinBinOp*>(&i))
+        bits = x86_lane_chunk(op->getOp());
+      else if (auto op = dynamic_cast<const X86IntrinTerOp*>(&i))
+        bits = x86_lane_chunk(op->getOp());
+      else if (auto op = dynamic_cast<const X86IntrinQuadOp*>(&i))
+        bits = x86_lane_chunk(op->getOp());
+      else if (dynamic_cast<const BinOp*>(&i) ||
+               dynamic_cast<const FpBinOp*>(&i) ||
+               dynamic_cast<const UnaryOp*>(&i) ||
+               dynamic_cast<const FpUnaryOp*>(&i) ||
+               dynamic_cast<const TernaryOp*>(&i) ||
+               dynamic_cast<const FpTernaryOp*>(&i) ||
+               dynamic_cast<const TestOp*>(&i) ||
+               dynamic_cast<const ConversionOp*>(&i) ||
+               dynamic_cast<const FpConversionOp*>(&i) ||
+               dynamic_cast<const Select*>(&i) ||
+               dynamic_cast<const ICmp*>(&i) ||
+               dynamic_cast<const FCmp*>(&i) ||
+               dynamic_cast<const Freeze*>(&i) ||
+               dynamic_cast<const Return*>(&i))
+        continue;
+      else
+        return 0;
+
+      if (bits == 0)
+        return 0;
+      chunk_bits = max(chunk_bits, bits);
+    }
+  }
+
+  unsigned lanes = aty->numElementsConst();
+  unsigned chunk = divide_up(chunk_bits, elem_bits);
+  return chunk < lanes && lanes % chunk == 0 ? chunk : 0;
+}
+
+// Runs query(i) for each i not yet done, in up to 'jobs' child processes.
+// The queries that are UNSAT are marked as done. Returns the first one found
+// that is not UNSAT, killing the remaining children, or -1 if there is none.
+static int
+parallel_first_not_unsat(vector<bool> &done, unsigned jobs,
+                         const function<Result(unsigned)> &query) {
+  struct Child {
+    pid_t pid;
+    int fd;
+    unsigned idx;
+  };
+  vector<Child> children;
+  unsigned next = 0;
+  int found = -1;
+
+  while (true) {
+    while (found < 0 && children.size() < jobs) {
+      while (next < done.size() && done[next])
+        ++next;
+      if (next == done.size())
+        break;
+
+      int fd[2];
+      pid_t pid = -1;
+      fflush(nullptr);
+      if (pipe(fd) == 0 && (pid = fork()) == 0) {
+        close(fd[0]);
+        char unsat = query(next).isUnsat();
+        ENSURE(write(fd[1], &unsat, 1) == 1);
+        _exit(0);
+      }
+
+      if (pid == -1) {
+        // couldn't fork; run it here instead
+        if (query(next).isUnsat())
+          done[next] = true;
+        else
+          found = next;
+        ++next;
+        continue;
+      }
+      close(fd[1]);
+      children.push_back({ pid, fd[0], next++ });
+    }
+
+    if (children.empty() || found >= 0)
+      break;
+
+    vector<pollfd> pfds;
+    for (auto &c : children) {
+      pfds.push_back({ c.fd, POLLIN, 0 });
+    }
+    if (poll(pfds.data(), pfds.size(), -1) < 0)
+      continue;
+
+    for (unsigned i = pfds.size(); i-- > 0; ) {
+      if (!pfds[i].revents)
+        continue;
+
+      auto &c = children[i];
+      // a child that died without answering counts as a failure, so that
+      // the query is rerun in the parent to report it
+      char unsat = 0;
+      if (read(c.fd, &unsat, 1) == 1 && unsat)
+        done[c.idx] = true;
+      else if (found < 0 || (int)c.idx < found)
+        found = c.idx;
+      close(c.fd);
+      waitpid(c.pid, nullptr, 0);
+      children.erase(children.begin() + i);
+    }
+  }
+
+  for (auto &c : children) {
+    kill(c.pid, SIGKILL);
+    close(c.fd);
+    waitpid(c.pid, nullptr, 0);
+  }
+  return found;
+}
+
 static void
 check_refinement(Errors &errs, const Transform &t, State &src_state,
                  State &tgt_state, const Value *var, const Type &type,
                  const State::ValTy &ap, const State::ValTy &bp,
-                 bool check_each_var) {
+                 bool check_each_var, expr *cex_inputs = nullptr) {
   auto &fndom_a  = ap.domain;
   auto &fndom_b  = bp.domain;
   auto &retdom_a = ap.return_domain;
@@ -496,8 +652,42 @@ check_refinement(Errors &errs, const Transform &t, State &src_state,
 
   AndExpr axioms = src_state.getAxioms();
   axioms.add(tgt_state.getAxioms());
+
   expr axioms_expr = axioms();
 
+  // All the queries below share the axioms, so they go into a single
+  // incremental solver that keeps what it learns between the queries; each
+  // query is checked in its own scope. That solver lacks the preprocessing of
+  // the tactic-based one and gets stuck on some large queries, so it only has
+  // a quarter of the timeout (all of it if that rounds down to 0ms), and the
+  // queries it doesn't answer are checked again from scratch with the
+  // tactic-based solver.
+  Solver s(true);
+  if (auto timeout = strtoul(get_query_timeout(), nullptr, 10) / 4)
+    s.setTimeout(timeout);
+  s.add(axioms_expr);
+
+  auto fallback = [&](Result &r, const expr &fml, optional<Solver> &fresh) {
+    if (!r.isTimeout() && !r.isError())
+      return;
+    fresh.emplace();
+    fresh->add(axioms_expr);
+    fresh->add(fml);
+    r = fresh->check();
+  };
+
+  auto check_fml = [&](const expr &fml) {
+    Result r;
+    {
+      SolverPush push(s);
+      s.add(fml);
+      r = s.check(true);
+    }
+    optional<Solver> fresh;
+    fallback(r, fml, fresh);
+    return r;
+  };
+
   // note that precondition->toSMT() may add stuff to getPre,
   // so order here matters
   // FIXME: broken handling of transformation precondition
@@ -511,27 +701,27 @@ check_refinement(Errors &errs, const Transform &t, State &src_state,
   expr pre_src = pre_src_and();
   expr pre_tgt = pre_tgt_and();
 
-  if (check_expr(axioms_expr && (pre_src && pre_tgt)).isUnsat()) {
+  if (check_fml(pre_src && pre_tgt).isUnsat()) {
     errs.add("Precondition is always false", false);
     return;
   }
 
   if (config::check_if_src_is_ub &&
-      check_expr(axioms_expr && fndom_a).isUnsat()) {
+      check_fml(fndom_a).isUnsat()) {
     errs.add("Source function is always UB", false);
     return;
   }
 
   {
     auto sink_src = src_state.sinkDomain();
-    if (!sink_src.isTrue() && check_expr(axioms_expr && !sink_src).isUnsat()) {
+    if (!sink_src.isTrue() && check_fml(!sink_src).isUnsat()) {
       errs.add("The source program doesn't reach a return instruction.\n"
                "Consider increasing the unroll factor if it has loops", false);
       return;
     }
 
     auto sink_tgt = tgt_state.sinkDomain();
-    if (!sink_tgt.isTrue() && check_expr(axioms_expr && !sink_tgt).isUnsat()) {
+    if (!sink_tgt.isTrue() && check_fml(!sink_tgt).isUnsat()) {
       errs.add("The target program doesn't reach a return instruction.\n"
                "Consider increasing the unroll factor if it has loops", false);
       return;
@@ -564,19 +754,24 @@ check_refinement(Errors &errs, const Transform &t, State &src_state,
     if (refines.isFalse())
       return std::move(refines);
 
-    return axioms_expr &&
-            preprocess(t, qvars, uvars, pre && pre_src_forall.implies(refines));
+    return preprocess(t, qvars, uvars, pre && pre_src_forall.implies(refines));
   };
 
   auto check = [&](expr &&e, auto &&printer, const char *msg) {
-    Solver s;
-    s.add(mk_fml(std::move(e)));
+    expr fml = mk_fml(std::move(e));
     e = expr();
-    auto res = s.check();
+    SolverPush push(s);
+    s.add(fml);
+    auto res = s.check(true);
+
+    optional<Solver> fresh;
+    fallback(res, fml, fresh);
+    fml = expr();
+    Solver &solver = fresh ? *fresh : s;
 
     if (!res.isUnsat() &&
-        !error(errs, src_state, tgt_state, res, s, var, msg, check_each_var,
-               printer))
+        !error(errs, src_state, tgt_state, res, solver, var, msg,
+               check_each_var, printer, cex_inputs))
       return false;
     return true;
   };
@@ -585,6 +780,10 @@ check_refinement(Errors &errs, const Transform &t, State &src_state,
   if (!check(fml, printer, msg)) \
     return
 
+#define CHECK_LANES(cnstrs, printer, msg) \
+  if (!check_lanes(cnstrs, printer, msg)) \
+    return
+
   if (config::disallow_ub_exploitation) {
     if (!null_is_dereferenceable)
       errs.add("Null is not dereferenceable", false);
@@ -632,14 +831,75 @@ check_refinement(Errors &errs, const Transform &t, State &src_state,
     CHECK(retdom_b && !b.non_poison, print_value, "Target returns poison");
   }
 
-  auto [poison_cnstr, value_cnstr] = type.refines(src_state, tgt_state, a, b);
+  expr poison_cnstr, value_cnstr;
+  // the constraints per chunk of lanes, if the query is split
+  vector<expr> poison_chunks, value_chunks;
+
+  // The query must be quantifier-free to be split, as the quantifiers
+  // don't distribute over the disjunction of the chunks.
+  if (unsigned chunk = config::split_vector_lanes && qvars.empty()
+                         ? lane_chunk(t, type) : 0) {
+    auto aty = type.getAsAggregateType();
+    for (unsigned i = 0, e = aty->numElementsConst(); i != e; i += chunk) {
+      set<expr> poison, value;
+      for (unsigned j = i; j != i + chunk; ++j) {
+        auto [p, v] = aty->getChild(j).refines(src_state, tgt_state,
+                                               aty->extract(a, j),
+                                               aty->extract(b, j));
+        poison.insert(std::move(p));
+        value.insert(std::move(v));
+      }
+      poison_chunks.emplace_back(expr::mk_and(poison));
+      value_chunks.emplace_back(expr::mk_and(value));
+    }
+    poison_cnstr = expr::mk_and(set<expr>(poison_chunks.begin(),
+                                          poison_chunks.end()));
+    value_cnstr = expr::mk_and(set<expr>(value_chunks.begin(),
+                                         value_chunks.end()));
+  } else {
+    tie(poison_cnstr, value_cnstr) = type.refines(src_state, tgt_state, a, b);
+  }
+
   expr dom = retdom_a && retdom_b;
   if (check_each_var)
     dom &= fndom_a && fndom_b;
 
+  // Checks dom && !(c_1 && ... && c_n) as the n queries dom && !c_i,
+  // stopping at the first counterexample.
+  auto check_lanes = [&](const vector<expr> &cnstrs, auto &&printer,
+                         const char *msg) {
+    unsigned jobs = config::split_vector_lanes;
+    if (jobs <= 1) {
+      for (auto &c : cnstrs) {
+        if (!check(dom && !c, printer, msg))
+          return false;
+      }
+      return true;
+    }
+
+    vector<bool> done(cnstrs.size());
+    while (true) {
+      int i = parallel_first_not_unsat(done, jobs, [&](unsigned i) {
+        return check_fml(mk_fml(dom && !cnstrs[i]));
+      });
+      if (i < 0)
+        return true;
+
+      // rerun it here to report the counterexample
+      done[i] = true;
+      if (!check(dom && !cnstrs[i], printer, msg))
+        return false;
+    }
+  };
+
   if (!config::disallow_ub_exploitation) {
-    CHECK(dom && !poison_cnstr,
-          print_value, "Target is more poisonous than source");
+    if (poison_chunks.empty()) {
+      CHECK(dom && !poison_cnstr,
+            print_value, "Target is more poisonous than source");
+    } else {
+      CHECK_LANES(poison_chunks,
+                  print_value, "Target is more poisonous than source");
+    }
   }
 
   // 4. Check undef
@@ -654,7 +914,11 @@ check_refinement(Errors &errs, const Transform &t, State &src_state,
   }
 
   // 5. Check value
-  CHECK(dom && !value_cnstr, print_value, "Value mismatch");
+  if (value_chunks.empty()) {
+    CHECK(dom && !value_cnstr, print_value, "Value mismatch");
+  } else {
+    CHECK_LANES(value_chunks, print_value, "Value mismatch");
+  }
 
   // 6. Check memory
   auto &src_mem = src_state.returnMemory();
@@ -677,6 +941,7 @@ check_refinement(Errors &errs, const Transform &t, State &src_state,
         print_ptr_load, "Mismatch in memory");
 
 #undef CHECK
+#undef CHECK_LANES
 }
 
 static bool has_nullptr(const Value *v) {
@@ -888,7 +1153,10 @@ static uint64_t aligned_alloc_size(uint64_t size, uint64_t align) {
   return add_saturate(size, align - 1);
 }
 
-void calculateAndInitConstants(Transform &t) {
+// With narrow_ptr_bits, offsets get at most that many bits. Returns false if
+// that is fewer than the program may need, i.e., if the narrowing may change
+// its behavior; only then are sizes narrowed as well.
+bool calculateAndInitConstants(Transform &t, unsigned narrow_ptr_bits = 0) {
   if (!bits_program_pointer)
     initBitsProgramPointer(t);
 
@@ -1174,6 +1442,17 @@ void calculateAndInitConstants(Transform &t) {
   bits_size_t = min(max(bits_for_offset, bits_size_t), bits_program_pointer-1);
   bits_size_t = min(bits_size_t, config::max_sizet_bits);
 
+  // The rounding up above is only for readability, so offsets of max_geps
+  // bits are as precise. bits_size_t bounds the size of non-local blocks, so
+  // it's only narrowed when the result is approximate anyway.
+  bool narrowing_exact = true;
+  if (narrow_ptr_bits && bits_for_offset > narrow_ptr_bits) {
+    narrowing_exact = narrow_ptr_bits >= max_geps;
+    bits_for_offset = narrow_ptr_bits;
+  }
+  if (!narrowing_exact)
+    bits_size_t = min(bits_size_t, narrow_ptr_bits);
+
   // +1 because the pointer after the object must be valid (can't overflow)
   uint64_t loc_alloc_aligned_size
     = max(loc_src_alloc_aligned_size, loc_tgt_alloc_aligned_size);
@@ -1232,6 +1511,8 @@ void calculateAndInitConstants(Transform &t) {
                   << "\ndoes_ptr_mem_access: " << does_ptr_mem_access
                   << "\ndoes_int_mem_access: " << does_int_mem_access
                   << '\n';
+
+  return narrowing_exact;
 }
 
 
@@ -1246,14 +1527,15 @@ TransformVerify::TransformVerify(Transform &t, bool check_each_var)
   }
 }
 
-pair<unique_ptr<State>, unique_ptr<State>> TransformVerify::exec() const {
+pair<unique_ptr<State>, unique_ptr<State>>
+TransformVerify::exec(unsigned narrow_ptr_bits) const {
   ScopedWatch symexec_watch([](auto &w) {
     if (w.seconds() > 5)
       dbg() << "WARNING: slow vcgen! Took " << w << '\n';
   });
 
   t.tgt.syncDataWithSrc(t.src);
-  calculateAndInitConstants(t);
+  calculateAndInitConstants(t, narrow_ptr_bits);
   State::resetGlobals();
 
   auto src_state = make_unique<State>(t.src, true);
@@ -1336,9 +1618,41 @@ Errors TransformVerify::verify() const {
     }
   }
 
+  // Abstraction-refinement over the pointer widths. If the narrow widths
+  // are as precise as the full ones, the narrow run is final. Otherwise, only
+  // a bug that shows up at full width with the same input values is
+  // reported; in every other case (no bug, spurious bug, timeout, ...) there's
+  // no other way but to verify at full width.
+  if (config::narrow_ptr_bits) {
+    bool exact;
+    try {
+      t.tgt.syncDataWithSrc(t.src);
+      exact = calculateAndInitConstants(t, config::narrow_ptr_bits);
+    } catch (AliveException e) {
+      return std::move(e);
+    }
+
+    if (exact)
+      return check(nullptr, nullptr, config::narrow_ptr_bits);
+
+    expr cex;
+    auto errs = check(nullptr, &cex, config::narrow_ptr_bits);
+    if (errs.isUnsound() && cex.isValid()) {
+      if (auto replay = check(&cex, nullptr, 0); replay.isUnsound())
+        return replay;
+    }
+  }
+
+  return check(nullptr, nullptr, 0);
+}
+
+Errors TransformVerify::check(const expr *pre, expr *cex_inputs,
+                              unsigned narrow_ptr_bits) const {
   Errors errs;
   try {
-    auto [src_state, tgt_state] = exec();
+    auto [src_state, tgt_state] = exec(narrow_ptr_bits);
+    if (pre)
+      src_state->addPre(expr(*pre));
 
     if (check_each_var) {
       for (auto &var : src_state->getFn().instrs()) {
@@ -1349,7 +1663,7 @@ Errors TransformVerify::verify() const {
 
         auto *val_tgt = tgt_state->at(*tgt_instrs.at(name));
         check_refinement(errs, t, *src_state, *tgt_state, &var, var.getType(),
-                         *val, *val_tgt, check_each_var);
+                         *val, *val_tgt, check_each_var, cex_inputs);
         if (errs)
           return errs;
       }
@@ -1357,7 +1671,7 @@ Errors TransformVerify::verify() const {
 
     check_refinement(errs, t, *src_state, *tgt_state, nullptr, t.src.getType(),
                      src_state->returnVal(), tgt_state->returnVal(),
-                     check_each_var);
+                     check_each_var, cex_inputs);
   } catch (AliveException e) {
     return std::move(e);
   }
@@ -1767,4 +2081,42 @@ ostream& operator<<(ostream &os, const Transform &t) {
   return os;
 }
 
+static bool is_name_char(char c) {
+  return isalnum((unsigned char)c) || c == '_' || c == '.' || c == '$' ||
+         c == '-' || c == '#';
+}
+
+string Transform::canonicalForm() const {
+  stringstream ss;
+  if (precondition) {
+    precondition->print(ss << "Pre: ");
+    ss << '\n';
+  }
+  src.printCanonical(ss);
+  ss << "=>\n";
+  tgt.printCanonical(ss);
+  string text = std::move(ss).str();
+
+  // Number the local names (%foo) in order of appearance. The same map is
+  // used for src and tgt, as their inputs are matched by name
+  unordered_map<string_view, unsigned> names;
+  string out;
+  out.reserve(text.size());
+  for (size_t i = 0, e = text.size(); i != e; ) {
+    if (text[i] != '%') {
+      out += text[i++];
+      continue;
+    }
+    size_t end = i + 1;
+    while (end != e && is_name_char(text[end]))
+      ++end;
+    string_view name(text.data() + i, end - i);
+    auto [I, inserted] = names.try_emplace(name, names.size());
+    out += '%';
+    out += to_string(I->second);
+    i = end;
+  }
+  return out;
+}
+
 }
@@ -30,6 +30,11 @@ struct Transform {
   void preprocess();
   void print(std::ostream &os, const TransformPrintOpts &opt = {}) const;
   friend std::ostream& operator<<(std::ostream &os, const Transform &t);
+
+  // Same for transformations that differ only in the names of the functions,
+  // values, and blocks, or in the order of the blocks; e.g., for clones
+  // produced by inlining. Used as a cache key
+  std::string canonicalForm() const;
 };
 
 
@@ -55,9 +60,13 @@ class TransformVerify {
   std::unordered_map<std::string, const IR::Instr*> tgt_instrs;
   bool check_each_var;
 
+  util::Errors check(const smt::expr *pre, smt::expr *cex_inputs,
+                     unsigned narrow_ptr_bits) const;
+
 public:
   TransformVerify(Transform &t, bool check_each_var);
-  std::pair<std::unique_ptr<IR::State>,std::unique_ptr<IR::State>> exec() const;
+  std::pair<std::unique_ptr<IR::State>,std::unique_ptr<IR::State>>
+    exec(unsigned narrow_ptr_bits = 0) const;
   util::Errors verify() const;
   TypingAssignments getTypings() const;
   void fixupTypes(const TypingAssignments &ty);
@@ -19,12 +19,17 @@
 #include "llvm/Passes/PassBuilder.h"
 #include "llvm/Passes/PassPlugin.h"
 #include "llvm/TargetParser/Triple.h"
+#include <atomic>
+#include <climits>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <random>
 #include <signal.h>
 #include <sstream>
+#include <thread>
 #include <unistd.h>
 #include <unordered_map>
 #include <utility>
@@ -46,7 +51,8 @@ llvm::cl::opt<string> parallel_tv("tv-parallel",
   llvm::cl::desc("Parallelization mode. Accepted values:"
                   " unrestricted (no throttling)"
                   ", fifo (use Alive2's job server)"
-                  ", null (developer mode)"),
+                  ", null (developer mode)"
+                  ", threads (in-process thread pool)"),
   llvm::cl::cat(alive_cmdargs));
 
 llvm::cl::opt<int> max_subprocesses("max-subprocesses",
@@ -70,18 +76,24 @@ struct FnInfo {
   unsigned n = 0;
 };
 
-optional<smt::smt_initializer> smt_init;
+// one per thread, as jobs of the threads backend use their own context
+thread_local optional<smt::smt_initializer> smt_init;
 optional<llvm_util::initializer> llvm_util_init;
 unordered_map<string, FnInfo> fns;
 unsigned initialized = 0;
 bool showed_stats = false;
-bool has_failure = false;
+atomic<bool> has_failure = false;
 bool is_clangtv = false;
 bool is_clangtv_done = false;
 unique_ptr<Cache> cache;
+// results of this run, so that duplicated transformations (e.g., clones of a
+// function made by inlining) are verified only once
+mutex run_results_mutex;
+unordered_map<Hash128, CacheEntry, Hash128::hasher> run_results;
 unique_ptr<parallel> parallelMgr;
 stringstream parent_ss;
-std::string SavedBitcode;
+// shared with the jobs of the threads backend
+shared_ptr<const string> SavedBitcode;
 string pass_name;
 
 void sigalarm_handler(int) {
@@ -110,7 +122,8 @@ void showStats() {
     IR::Memory::printAliasStats(*out);
 }
 
-void writeBitcode(const fs::path &report_filename) {
+void writeBitcode(const fs::path &report_filename, const string &bitcode,
+                  ostream &out) {
   fs::path bc_filename;
   if (report_filename.empty()) {
     bc_filename = get_random_str(8) + ".bc";
@@ -125,15 +138,17 @@ void writeBitcode(const fs::path &report_filename) {
     cerr << "Alive2: Couldn't open bitcode file" << endl;
     exit(1);
   }
-  bc_file << SavedBitcode;
+  bc_file << bitcode;
   bc_file.close();
-  *out << "Wrote bitcode to: " << bc_filename << '\n';
+  out << "Wrote bitcode to: " << bc_filename << '\n';
 }
 
 void saveBitcode(const llvm::Module *M) {
-  SavedBitcode.clear();
-  llvm::raw_string_ostream OS(SavedBitcode);
+  string bitcode;
+  llvm::raw_string_ostream OS(bitcode);
   WriteBitcodeToFile(*M, OS);
+  OS.flush();
+  SavedBitcode = make_shared<const string>(std::move(bitcode));
 }
 
 void emitCommandLine(ostream *out) {
@@ -159,12 +174,46 @@ struct TVLegacyPass final : public llvm::ModulePass {
     = nullptr;
   unsigned anon_count = 0;
 
+  struct Query {
+    Transform t;
+    unsigned n;
+    string src_tostr, tgt_tostr;
+    Hash128 key;
+  };
+  // transformations of the module whose verification was put off
+  optional<vector<Query>> deferred;
+
   TVLegacyPass() : ModulePass(ID) {}
 
   bool runOnModule(llvm::Module &M) override {
     anon_count = 0;
+    // With a remote cache, first translate all the functions so that their
+    // cache entries are fetched at once rather than with a round-trip each
+    if (cache && cache->wantsPrefetch() && !opt_assume_cache_hit &&
+        !opt_elapsed_time)
+      deferred.emplace();
+
     for (auto &F: M)
       runOn(F);
+
+    if (deferred) {
+      vector<Hash128> keys;
+      for (auto &q : *deferred) {
+        if (opt_always_verify || q.src_tostr != q.tgt_tostr) {
+          q.key = getKey(q.t);
+          keys.emplace_back(q.key);
+        }
+      }
+      cache->prefetch(keys);
+
+      auto queries = std::move(*deferred);
+      deferred.reset();
+      for (auto &q : queries)
+        verify(q.t, q.n, q.src_tostr, q.tgt_tostr, &q.key);
+    }
+
+    if (cache)
+      cache->flush();
     return false;
   }
 
@@ -227,8 +276,13 @@ struct TVLegacyPass final : public llvm::ModulePass {
     Transform t;
     t.src = std::move(I->second.fn);
     t.tgt = std::move(*fn);
+    auto tgt_tostr = toString(t.tgt);
 
-    verify(t, I->second.n++, I->second.fn_tostr);
+    if (deferred)
+      deferred->push_back({ std::move(t), I->second.n++, I->second.fn_tostr,
+                            std::move(tgt_tostr) });
+    else
+      verify(t, I->second.n++, I->second.fn_tostr, tgt_tostr);
 
     fn = llvm2alive(F, *TLI, true);
     if (!fn) {
@@ -241,10 +295,23 @@ struct TVLegacyPass final : public llvm::ModulePass {
     return false;
   }
 
-  static void verify(Transform &t, int n, const string &src_tostr) {
+  static Hash128 getKey(const Transform &t) {
+    return Cache::getKey(t.canonicalForm());
+  }
+
+  static void storeResult(const Hash128 &key, const CacheEntry &entry) {
+    {
+      lock_guard lock(run_results_mutex);
+      run_results[key] = entry;
+    }
+    if (cache)
+      cache->store(key, entry);
+  }
+
+  static void verify(Transform &t, int n, const string &src_tostr,
+                     const string &tgt_tostr, const Hash128 *key_p = nullptr) {
     printDot(t.tgt, n);
 
-    auto tgt_tostr = toString(t.tgt);
     if (!opt_always_verify) {
       // Compare Alive2 IR and skip if syntactically equal
       if (src_tostr == tgt_tostr) {
@@ -258,11 +325,54 @@ struct TVLegacyPass final : public llvm::ModulePass {
       }
     }
 
+    if (opt_assume_cache_hit) {
+      *out << "Skipping repeated query\n\n";
+      return;
+    }
+
+    Hash128 key = key_p ? *key_p : getKey(t);
+    {
+      lock_guard lock(run_results_mutex);
+      auto [I, inserted] = run_results.try_emplace(key);
+      if (!inserted && reportCached(I->second)) {
+        if (opt_error_fatal && has_failure)
+          finalize();
+        return;
+      }
+      I->second = CacheEntry();
+    }
+
     // Since we have an open connection to the Redis server, we have
     // to do this before forking. Anyway, this is fast.
-    if (opt_assume_cache_hit ||
-        (cache && cache->lookup(src_tostr + "===\n" + tgt_tostr))) {
-      *out << "Skipping repeated query\n\n";
+    if (cache) {
+      if (auto entry = cache->lookup(key); entry && reportCached(*entry)) {
+        storeResult(key, *entry);
+        if (opt_error_fatal && has_failure)
+          finalize();
+        return;
+      }
+    }
+
+    if (parallelMgr && !parallelMgr->forks()) {
+      // don't start more jobs once one of them found a bug
+      if (opt_error_fatal && has_failure)
+        finalize();
+
+      /*
+       * the job takes the transformation; leave a placeholder in the
+       * output that we'll patch up later
+       */
+      auto job = [tp = make_shared<Transform>(std::move(t)), key,
+                  pass = pass_name, bitcode = SavedBitcode](ostream &os) {
+        config::set_debug(os);
+        if (smt_init)
+          smt_init->reset();
+        else
+          smt_init.emplace();
+        auto entry = check(*tp, os, pass, bitcode.get());
+        storeResult(key, entry);
+      };
+      *out << "include(" << parallelMgr->submit(std::move(job)) << ")\n";
       return;
     }
 
@@ -309,48 +419,107 @@ struct TVLegacyPass final : public llvm::ModulePass {
      */
 
     smt_init->reset();
+    auto entry = check(t, *out, pass_name, SavedBitcode.get());
+    storeResult(key, entry);
+    if (opt_error_fatal && has_failure)
+      finalize();
+
+    if (parallelMgr) {
+      if (cache)
+        cache->flush();
+      showStats();
+      signal(SIGALRM, SIG_IGN);
+      llvm_util_init.reset();
+      smt_init.reset();
+      parallelMgr->finishChild(/*is_timeout=*/false);
+      exit(0);
+    }
+  }
+
+  static unsigned queryTimeout() {
+    return strtoul(smt::get_query_timeout(), nullptr, 10);
+  }
+
+  // Prints the result of a previous verification unless it's worth
+  // verifying the transformation again
+  static bool reportCached(const CacheEntry &entry) {
+    if (entry.verdict == CacheEntry::Error ||
+        (entry.verdict != CacheEntry::Seen &&
+         entry.fingerprint != Cache::fingerprint() &&
+         !opt_cache_allow_version_mismatch))
+      return false;
+
+    // retry if we now have a bigger budget (0 = no timeout)
+    auto budget = [](unsigned ms) { return ms ? ms : UINT_MAX; };
+    if (entry.verdict == CacheEntry::Timeout &&
+        budget(entry.timeout) < budget(queryTimeout()))
+      return false;
+
+    *out << "Skipping repeated query\n";
+    switch (entry.verdict) {
+    case CacheEntry::Seen:
+    case CacheEntry::Correct:
+      break;
+    case CacheEntry::Unsound:
+      has_failure = true;
+      [[fallthrough]];
+    default:
+      *out << "Transformation doesn't verify! ("
+           << (entry.verdict == CacheEntry::Unsound ? "unsound" : "not unsound")
+           << ", cached)\n" << entry.details;
+    }
+    *out << '\n';
+    return true;
+  }
+
+  static CacheEntry check(Transform &t, ostream &out, const string &pass,
+                          const string *bitcode) {
+    CacheEntry entry;
+    entry.timeout = queryTimeout();
+    entry.fingerprint = Cache::fingerprint();
+    StopWatch sw;
     t.preprocess();
     TransformVerify verifier(t, false);
     if (!opt_quiet)
-      t.print(*out);
+      t.print(out);
 
     {
       auto types = verifier.getTypings();
       if (!types) {
-        *out << "Transformation doesn't verify!\n"
-                "ERROR: program doesn't type check!\n\n";
-        goto done;
+        entry.verdict = CacheEntry::TypeCheckFailed;
+        entry.details = "ERROR: program doesn't type check!\n";
+        out << "Transformation doesn't verify!\n" << entry.details << '\n';
+        return entry;
       }
       assert(types.hasSingleTyping());
     }
 
     if (Errors errs = verifier.verify()) {
-      *out << "Transformation doesn't verify!" <<
-              (errs.isUnsound() ? " (unsound)\n" : " (not unsound)\n")
-           << errs;
+      stringstream ss;
+      ss << errs;
+      entry.details = std::move(ss).str();
+      entry.verdict = errs.isUnsound()     ? CacheEntry::Unsound
+                    : errs.isSolverError() ? CacheEntry::Error
+                    : errs.isTimeout()     ? CacheEntry::Timeout
+                                           : CacheEntry::FailedToProve;
+      out << "Transformation doesn't verify!" <<
+             (errs.isUnsound() ? " (unsound)\n" : " (not unsound)\n")
+          << entry.details;
       if (errs.isUnsound()) {
         has_failure = true;
-        *out << "\nPass: " << pass_name << '\n';
-        emitCommandLine(out);
-        if (!SavedBitcode.empty())
-          writeBitcode(report_filename);
-        *out << "\n";
+        out << "\nPass: " << pass << '\n';
+        emitCommandLine(&out);
+        if (bitcode && !bitcode->empty())
+          writeBitcode(report_filename, *bitcode, out);
+        out << "\n";
       }
-      if (opt_error_fatal && has_failure)
-        finalize();
     } else {
-      *out << "Transformation seems to be correct!\n\n";
-    }
-
-  done:
-    if (parallelMgr) {
-      showStats();
-      signal(SIGALRM, SIG_IGN);
-      llvm_util_init.reset();
-      smt_init.reset();
-      parallelMgr->finishChild(/*is_timeout=*/false);
-      exit(0);
+      out << "Transformation seems to be correct!\n\n";
+      entry.verdict = CacheEntry::Correct;
     }
+    sw.stop();
+    entry.time = sw.seconds();
+    return entry;
   }
 
  bool doInitialization(llvm::Module &module) override {
@@ -376,6 +545,10 @@ struct TVLegacyPass final : public llvm::ModulePass {
       parallelMgr = make_unique<fifo>(max_subprocesses, parent_ss, *out);
     } else if (parallel_tv == "null") {
       parallelMgr = make_unique<null>(max_subprocesses, parent_ss, *out);
+    } else if (parallel_tv == "threads") {
+      int nthreads = max(1u, thread::hardware_concurrency());
+      parallelMgr = make_unique<threads>(min((int)max_subprocesses, nthreads),
+                                         parent_ss, *out);
     } else if (!parallel_tv.empty()) {
       *out << "Alive2: Unknown parallelization mode: " << parallel_tv << endl;
       exit(1);
@@ -392,6 +565,11 @@ struct TVLegacyPass final : public llvm::ModulePass {
       }
     }
 
+    // The lane subqueries run in forked children, but forking while other
+    // threads are inside Z3 may leave the child blocked on one of its locks
+    if (parallelMgr && !parallelMgr->forks() && config::split_vector_lanes > 1)
+      config::split_vector_lanes = 1;
+
     showed_stats = false;
     llvm_util_init.emplace(*out, module.getDataLayout());
     smt_init.emplace();
@@ -404,15 +582,18 @@ struct TVLegacyPass final : public llvm::ModulePass {
   }
 
   static void finalize() {
-    SavedBitcode.resize(0);
+    SavedBitcode.reset();
     if (parallelMgr) {
       parallelMgr->finishParent();
       out = out_file.is_open() ? &out_file : &cout;
       set_outs(*out);
     }
+    // the cache itself is kept for the next initialization
+    if (cache)
+      cache->flush();
 
-    // If it is run in parallel, stats are shown by children
-    if (!showed_stats && !parallelMgr) {
+    // If it is run in child processes, stats are shown by them
+    if (!showed_stats && (!parallelMgr || !parallelMgr->forks())) {
       showed_stats = true;
       showStats();
       if (has_failure && !report_filename.empty())
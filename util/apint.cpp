@@ -0,0 +1,280 @@
+// Copyright (c) 2018-present The Alive2 Authors.
+// Distributed under the MIT license that can be found in the LICENSE file.
+
+#include "util/apint.h"
+#include "util/compiler.h"
+#include <algorithm>
+
+using namespace std;
+
+static unsigned num_words(unsigned bits) {
+  return (bits + 63) / 64;
+}
+
+static void udivrem(const util::APInt &a, const util::APInt &b,
+                    util::APInt *q, util::APInt *r) {
+  auto bw = a.bits();
+  if (bw <= 64) {
+    uint64_t x = a.getWords()[0], y = b.getWords()[0];
+    // SMT-LIB: x / 0 = all ones, x % 0 = x
+    if (q)
+      *q = y ? util::APInt(bw, x / y) : ~util::APInt(bw);
+    if (r)
+      *r = util::APInt(bw, y ? x % y : x);
+    return;
+  }
+
+  if (b.isZero()) {
+    if (q)
+      *q = ~util::APInt(bw);
+    if (r)
+      *r = a;
+    return;
+  }
+
+  // restoring division, one bit at a time
+  util::APInt quot(bw), rem(bw), one(bw, 1);
+  for (unsigned i = bw; i-- > 0; ) {
+    bool carry = rem.isNegative();
+    rem = rem.shl(1);
+    if (a.getBit(i))
+      rem = rem | one;
+    if (carry || !rem.ult(b)) {
+      rem = rem - b;
+      quot = quot | one.shl(i);
+    }
+  }
+  if (q)
+    *q = std::move(quot);
+  if (r)
+    *r = std::move(rem);
+}
+
+namespace util {
+
+APInt::APInt(unsigned bits, uint64_t val) : bw(bits), words(num_words(bits)) {
+  assert(bits > 0);
+  words[0] = val;
+  clearUnusedBits();
+}
+
+APInt::APInt(unsigned bits, vector<uint64_t> w)
+  : bw(bits), words(std::move(w)) {
+  assert(bits > 0);
+  words.resize(num_words(bits));
+  clearUnusedBits();
+}
+
+void APInt::clearUnusedBits() {
+  if (bw % 64)
+    words.back() &= UINT64_MAX >> (64 - bw % 64);
+}
+
+bool APInt::getBit(unsigned i) const {
+  assert(i < bw);
+  return (words[i / 64] >> (i % 64)) & 1;
+}
+
+bool APInt::isZero() const {
+  return all_of(words.begin(), words.end(), [](auto w) { return w == 0; });
+}
+
+uint64_t APInt::getLimitedValue() const {
+  return all_of(words.begin() + 1, words.end(), [](auto w) { return w == 0; })
+           ? words[0] : UINT64_MAX;
+}
+
+APInt APInt::operator~() const {
+  APInt r(*this);
+  for (auto &w : r.words) {
+    w = ~w;
+  }
+  r.clearUnusedBits();
+  return r;
+}
+
+APInt APInt::operator-() const {
+  return APInt(bw) - *this;
+}
+
+APInt APInt::operator&(const APInt &rhs) const {
+  assert(bw == rhs.bw);
+  APInt r(*this);
+  for (unsigned i = 0, e = numWords(); i != e; ++i) {
+    r.words[i] &= rhs.words[i];
+  }
+  return r;
+}
+
+APInt APInt::operator|(const APInt &rhs) const {
+  assert(bw == rhs.bw);
+  APInt r(*this);
+  for (unsigned i = 0, e = numWords(); i != e; ++i) {
+    r.words[i] |= rhs.words[i];
+  }
+  return r;
+}
+
+APInt APInt::operator^(const APInt &rhs) const {
+  assert(bw == rhs.bw);
+  APInt r(*this);
+  for (unsigned i = 0, e = numWords(); i != e; ++i) {
+    r.words[i] ^= rhs.words[i];
+  }
+  return r;
+}
+
+APInt APInt::operator+(const APInt &rhs) const {
+  assert(bw == rhs.bw);
+  APInt r(*this);
+  uint64_t carry = 0;
+  for (unsigned i = 0, e = numWords(); i != e; ++i) {
+    uint64_t sum = words[i] + carry;
+    carry = sum < carry;
+    r.words[i] = sum + rhs.words[i];
+    carry |= r.words[i] < sum;
+  }
+  r.clearUnusedBits();
+  return r;
+}
+
+APInt APInt::operator-(const APInt &rhs) const {
+  assert(bw == rhs.bw);
+  APInt r(*this);
+  uint64_t borrow = 0;
+  for (unsigned i = 0, e = numWords(); i != e; ++i) {
+    uint64_t diff = words[i] - borrow;
+    borrow = words[i] < borrow;
+    r.words[i] = diff - rhs.words[i];
+    borrow |= diff < rhs.words[i];
+  }
+  r.clearUnusedBits();
+  return r;
+}
+
+APInt APInt::operator*(const APInt &rhs) const {
+  assert(bw == rhs.bw);
+  APInt r(bw);
+  unsigned n = numWords();
+  for (unsigned i = 0; i != n; ++i) {
+    unsigned __int128 carry = 0;
+    for (unsigned j = 0; i + j != n; ++j) {
+      carry += (unsigned __int128)words[i] * rhs.words[j] + r.words[i + j];
+      r.words[i + j] = (uint64_t)carry;
+      carry >>= 64;
+    }
+  }
+  r.clearUnusedBits();
+  return r;
+}
+
+APInt APInt::udiv(const APInt &rhs) const {
+  assert(bw == rhs.bw);
+  APInt q(bw);
+  udivrem(*this, rhs, &q, nullptr);
+  return q;
+}
+
+APInt APInt::urem(const APInt &rhs) const {
+  assert(bw == rhs.bw);
+  APInt r(bw);
+  udivrem(*this, rhs, nullptr, &r);
+  return r;
+}
+
+APInt APInt::sdiv(const APInt &rhs) const {
+  bool neg_a = isNegative(), neg_b = rhs.isNegative();
+  APInt q = (neg_a ? -*this : *this).udiv(neg_b ? -rhs : rhs);
+  return neg_a != neg_b ? -q : q;
+}
+
+APInt APInt::srem(const APInt &rhs) const {
+  // the sign follows the dividend
+  bool neg_a = isNegative();
+  APInt r = (neg_a ? -*this : *this).urem(rhs.isNegative() ? -rhs : rhs);
+  return neg_a ? -r : r;
+}
+
+APInt APInt::shl(uint64_t amount) const {
+  APInt r(bw);
+  if (amount >= bw)
+    return r;
+
+  unsigned word_shift = amount / 64, bit_shift = amount % 64;
+  for (unsigned i = numWords(); i-- > word_shift; ) {
+    uint64_t w = words[i - word_shift] << bit_shift;
+    if (bit_shift && i > word_shift)
+      w |= words[i - word_shift - 1] >> (64 - bit_shift);
+    r.words[i] = w;
+  }
+  r.clearUnusedBits();
+  return r;
+}
+
+APInt APInt::lshr(uint64_t amount) const {
+  APInt r(bw);
+  if (amount >= bw)
+    return r;
+
+  unsigned word_shift = amount / 64, bit_shift = amount % 64;
+  unsigned n = numWords();
+  for (unsigned i = 0; i + word_shift < n; ++i) {
+    uint64_t w = words[i + word_shift] >> bit_shift;
+    if (bit_shift && i + word_shift + 1 < n)
+      w |= words[i + word_shift + 1] << (64 - bit_shift);
+    r.words[i] = w;
+  }
+  return r;
+}
+
+APInt APInt::ashr(uint64_t amount) const {
+  if (!isNegative())
+    return lshr(amount);
+  if (amount >= bw)
+    return ~APInt(bw);
+  return ~(~*this).lshr(amount);
+}
+
+bool APInt::ult(const APInt &rhs) const {
+  assert(bw == rhs.bw);
+  for (unsigned i = numWords(); i-- > 0; ) {
+    if (words[i] != rhs.words[i])
+      return words[i] < rhs.words[i];
+  }
+  return false;
+}
+
+bool APInt::slt(const APInt &rhs) const {
+  bool neg_a = isNegative(), neg_b = rhs.isNegative();
+  return neg_a != neg_b ? neg_a : ult(rhs);
+}
+
+APInt APInt::concat(const APInt &rhs) const {
+  APInt r = zext(rhs.bw).shl(rhs.bw);
+  for (unsigned i = 0, e = rhs.numWords(); i != e; ++i) {
+    r.words[i] |= rhs.words[i];
+  }
+  return r;
+}
+
+APInt APInt::extract(unsigned high, unsigned low) const {
+  assert(high >= low && high < bw);
+  APInt r = lshr(low);
+  r.bw = high - low + 1;
+  r.words.resize(num_words(r.bw));
+  r.clearUnusedBits();
+  return r;
+}
+
+APInt APInt::sext(unsigned amount) const {
+  APInt r = zext(amount);
+  if (amount && isNegative())
+    r = r | (~APInt(amount)).zext(bw).shl(bw);
+  return r;
+}
+
+APInt APInt::zext(unsigned amount) const {
+  return APInt(bw + amount, words);
+}
+
+}
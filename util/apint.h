@@ -0,0 +1,65 @@
+#pragma once
+
+// Copyright (c) 2018-present The Alive2 Authors.
+// Distributed under the MIT license that can be found in the LICENSE file.
+
+#include <cstdint>
+#include <vector>
+
+namespace util {
+
+// Arbitrary-width bit-vector constant with the semantics of the SMT-LIB
+// operations, e.g., division by zero is defined.
+class APInt final {
+  unsigned bw;
+  // least significant first; the bits above bw are always zero
+  std::vector<uint64_t> words;
+
+  void clearUnusedBits();
+  unsigned numWords() const { return words.size(); }
+
+public:
+  APInt(unsigned bits, uint64_t val = 0);
+  APInt(unsigned bits, std::vector<uint64_t> words);
+
+  unsigned bits() const { return bw; }
+  const std::vector<uint64_t>& getWords() const { return words; }
+
+  bool getBit(unsigned i) const;
+  bool isZero() const;
+  bool isNegative() const { return getBit(bw - 1); }
+  // the value, or UINT64_MAX if it doesn't fit
+  uint64_t getLimitedValue() const;
+
+  APInt operator~() const;
+  APInt operator-() const;
+  APInt operator&(const APInt &rhs) const;
+  APInt operator|(const APInt &rhs) const;
+  APInt operator^(const APInt &rhs) const;
+  APInt operator+(const APInt &rhs) const;
+  APInt operator-(const APInt &rhs) const;
+  APInt operator*(const APInt &rhs) const;
+
+  APInt udiv(const APInt &rhs) const;
+  APInt urem(const APInt &rhs) const;
+  APInt sdiv(const APInt &rhs) const;
+  APInt srem(const APInt &rhs) const;
+
+  APInt shl(uint64_t amount) const;
+  APInt lshr(uint64_t amount) const;
+  APInt ashr(uint64_t amount) const;
+
+  bool operator==(const APInt &rhs) const = default;
+  bool ult(const APInt &rhs) const;
+  bool ule(const APInt &rhs) const { return !rhs.ult(*this); }
+  bool slt(const APInt &rhs) const;
+  bool sle(const APInt &rhs) const { return !rhs.slt(*this); }
+
+  // this becomes the most significant part
+  APInt concat(const APInt &rhs) const;
+  APInt extract(unsigned high, unsigned low) const;
+  APInt sext(unsigned amount) const;
+  APInt zext(unsigned amount) const;
+};
+
+}
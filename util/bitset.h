@@ -0,0 +1,134 @@
+#pragma once
+
+// Copyright (c) 2018-present The Alive2 Authors.
+// Distributed under the MIT license that can be found in the LICENSE file.
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <compare>
+#include <cstdint>
+#include <vector>
+
+namespace util {
+
+// Fixed-size bitset that keeps up to 128 bits inline and falls back to the
+// heap for larger sizes. Set operations work a 64-bit word at a time.
+// Invariant: the bits past size() in the last word are always zero.
+class SmallBitSet {
+  static constexpr unsigned InlineWords = 2;
+
+  unsigned nbits = 0;
+  std::array<uint64_t, InlineWords> inline_words = {};
+  std::vector<uint64_t> heap_words;
+
+  static unsigned numWords(unsigned bits) { return (bits + 63) / 64; }
+
+  bool isInline() const { return numWords(nbits) <= InlineWords; }
+  uint64_t* words() {
+    return isInline() ? inline_words.data() : heap_words.data();
+  }
+  const uint64_t* words() const {
+    return isInline() ? inline_words.data() : heap_words.data();
+  }
+
+  // mask of the valid bits of word w of a set of the given size
+  static uint64_t wordMask(unsigned bits, unsigned w) {
+    unsigned rem = bits - w * 64;
+    return rem >= 64 ? ~uint64_t(0) : (uint64_t(1) << rem) - 1;
+  }
+
+public:
+  SmallBitSet() = default;
+  SmallBitSet(unsigned nbits) : nbits(nbits) {
+    if (!isInline())
+      heap_words.resize(numWords(nbits), 0);
+  }
+
+  unsigned size() const { return nbits; }
+
+  bool test(unsigned i) const {
+    return (words()[i / 64] >> (i % 64)) & 1;
+  }
+
+  void set(unsigned i) { words()[i / 64] |= uint64_t(1) << (i % 64); }
+  void reset(unsigned i) { words()[i / 64] &= ~(uint64_t(1) << (i % 64)); }
+
+  // sets bits [0, limit]
+  void setUpTo(unsigned limit) {
+    auto *w = words();
+    unsigned full = (limit + 1) / 64;
+    std::fill(w, w + full, ~uint64_t(0));
+    if (unsigned rem = (limit + 1) % 64)
+      w[full] |= (uint64_t(1) << rem) - 1;
+  }
+
+  unsigned count() const {
+    unsigned n = 0;
+    for (auto *w = words(), *e = w + numWords(nbits); w != e; ++w) {
+      n += std::popcount(*w);
+    }
+    return n;
+  }
+
+  // index of the first unset bit, or size() if all bits are set
+  unsigned countTrailingOnes() const {
+    auto *w = words();
+    for (unsigned i = 0, e = numWords(nbits); i != e; ++i) {
+      if (~w[i])
+        return std::min(i * 64 + std::countr_one(w[i]), nbits);
+    }
+    return nbits;
+  }
+
+  // index of the first set bit at or after i, or size() if there is none
+  unsigned findNext(unsigned i) const {
+    if (i >= nbits)
+      return nbits;
+    auto *w = words();
+    unsigned wi = i / 64;
+    uint64_t word = w[wi] & (~uint64_t(0) << (i % 64));
+    for (unsigned e = numWords(nbits);;) {
+      if (word)
+        return wi * 64 + std::countr_zero(word);
+      if (++wi == e)
+        return nbits;
+      word = w[wi];
+    }
+  }
+
+  // Both operations only touch the bits below min(size(), other.size()).
+  void intersectWith(const SmallBitSet &other) {
+    auto *a = words();
+    auto *b = other.words();
+    unsigned bits = std::min(nbits, other.nbits);
+    for (unsigned i = 0, e = numWords(bits); i != e; ++i) {
+      a[i] &= b[i] | ~wordMask(bits, i);
+    }
+  }
+
+  void unionWith(const SmallBitSet &other) {
+    auto *a = words();
+    auto *b = other.words();
+    unsigned bits = std::min(nbits, other.nbits);
+    for (unsigned i = 0, e = numWords(bits); i != e; ++i) {
+      a[i] |= b[i] & wordMask(bits, i);
+    }
+  }
+
+  std::strong_ordering operator<=>(const SmallBitSet &rhs) const {
+    if (auto cmp = nbits <=> rhs.nbits; std::is_neq(cmp))
+      return cmp;
+    auto *a = words();
+    auto *b = rhs.words();
+    for (unsigned i = 0, e = numWords(nbits); i != e; ++i) {
+      if (auto cmp = a[i] <=> b[i]; std::is_neq(cmp))
+        return cmp;
+    }
+    return std::strong_ordering::equal;
+  }
+
+  bool operator==(const SmallBitSet &rhs) const { return (*this <=> rhs) == 0; }
+};
+
+}
@@ -6,7 +6,8 @@
 
 using namespace std;
 
-static ostream *debug_os = &cerr;
+// per thread, so that concurrent jobs can log to their own buffers
+static thread_local ostream *debug_os = &cerr;
 
 namespace util::config {
 
@@ -23,6 +24,9 @@ unsigned src_unroll_cnt = 0;
 unsigned tgt_unroll_cnt = 0;
 unsigned max_offset_bits = 64;
 unsigned max_sizet_bits = 64;
+unsigned narrow_ptr_bits = 0;
+bool x86_shuffle_mux = false;
+unsigned split_vector_lanes = 0;
 
 ostream &dbg() {
   return *debug_os;
@@ -44,6 +44,23 @@ extern unsigned max_offset_bits;
 // size and size of pointers (not to be confused with program pointer size).
 extern unsigned max_sizet_bits;
 
+// If non-zero, first verify with the offset width capped to this many bits.
+// That result is final only if the narrow width still fits all the offsets of
+// the program (size_t is then left as is). Otherwise size_t is capped too, a
+// bug found with them is only reported if it reproduces at full width, and
+// correctness is established at full width.
+extern unsigned narrow_ptr_bits;
+
+// Encode x86 variable shuffles (pshufb, vpermi2var) as a tree of ites over
+// the candidate elements instead of shifting the whole vector by a symbolic
+// amount. This is friendlier to bit-blasting, especially for 512-bit vectors.
+extern bool x86_shuffle_mux;
+
+// Check the poison and value refinement of lane-separable vector results as
+// one query per chunk of lanes. 0 disables it, 1 runs the queries one after
+// the other, and N > 1 runs up to N of them in parallel child processes.
+extern unsigned split_vector_lanes;
+
 std::ostream &dbg();
 void set_debug(std::ostream &os);
 
@@ -0,0 +1,52 @@
+#pragma once
+
+// Copyright (c) 2018-present The Alive2 Authors.
+// Distributed under the MIT license that can be found in the LICENSE file.
+
+#include <compare>
+#include <memory>
+#include <utility>
+
+namespace util {
+
+// Copy-on-write value: copies share the same object until one of them calls
+// write(). Not thread-safe; copies must stay within a thread.
+// A default-constructed or moved-from COW holds T() without allocating it.
+template <typename T>
+class COW {
+  std::shared_ptr<T> ptr;
+
+  static const T& empty() {
+    static const T val;
+    return val;
+  }
+
+public:
+  COW() = default;
+  COW(T &&val) : ptr(std::make_shared<T>(std::move(val))) {}
+  COW(const T &val) : ptr(std::make_shared<T>(val)) {}
+
+  const T& operator*() const { return ptr ? *ptr : empty(); }
+  const T* operator->() const { return &**this; }
+
+  T& write() {
+    if (!ptr)
+      ptr = std::make_shared<T>();
+    else if (ptr.use_count() > 1)
+      ptr = std::make_shared<T>(*ptr);
+    return *ptr;
+  }
+
+  bool sharedWith(const COW &other) const { return ptr == other.ptr; }
+
+  auto operator<=>(const COW &rhs) const
+    -> decltype(std::declval<const T&>() <=> std::declval<const T&>()) {
+    if (ptr == rhs.ptr)
+      return std::strong_ordering::equivalent;
+    return **this <=> *rhs;
+  }
+
+  bool operator==(const COW &rhs) const { return (*this <=> rhs) == 0; }
+};
+
+}
@@ -41,6 +41,18 @@ bool Errors::isUnsound() const {
   return false;
 }
 
+bool Errors::isTimeout() const {
+  return errs.count({ "Timeout", false });
+}
+
+bool Errors::isSolverError() const {
+  for (auto &[msg, unsound] : errs) {
+    if (msg.starts_with("SMT Error"))
+      return true;
+  }
+  return false;
+}
+
 ostream& operator<<(ostream &os, const Errors &errs) {
   for (auto &[msg, unsound] : errs.errs) {
     os << "ERROR: " << msg << '\n';
@@ -35,6 +35,8 @@ public:
 
   explicit operator bool() const { return !errs.empty(); }
   bool isUnsound() const;
+  bool isTimeout() const;
+  bool isSolverError() const;
 
   friend std::ostream& operator<<(std::ostream &os, const Errors &e);
 };
@@ -1,4 +1,8 @@
+#pragma once
+
+#include <cstdint>
 #include <cstring>
+#include <string>
 
 // halfsip(2,4) hash
 // Inspired from https://github.com/veorq/SipHash/blob/master/halfsiphash.c
@@ -106,3 +110,88 @@ public:
     return out;
   }
 };
+
+// 128-bit MurmurHash3 (x64 variant)
+// Adapted from https://github.com/aappleby/smhasher/blob/master/src/MurmurHash3.cpp
+// In public domain
+// For content-addressed keys, where 32 bits would collide on large corpora.
+struct Hash128 {
+  uint64_t lo = 0, hi = 0;
+
+  bool operator==(const Hash128 &rhs) const = default;
+
+  std::string str() const {
+    static const char digits[] = "0123456789abcdef";
+    std::string s(32, '0');
+    for (unsigned i = 0; i < 16; ++i) {
+      s[15 - i] = digits[(hi >> (4 * i)) & 0xf];
+      s[31 - i] = digits[(lo >> (4 * i)) & 0xf];
+    }
+    return s;
+  }
+
+  struct hasher {
+    size_t operator()(const Hash128 &h) const { return h.lo; }
+  };
+};
+
+inline Hash128 hash128(const void *data, size_t len, uint64_t seed = 0) {
+  auto rotl = [](uint64_t x, int r) { return (x << r) | (x >> (64 - r)); };
+  auto fmix = [](uint64_t k) {
+    k ^= k >> 33;
+    k *= UINT64_C(0xff51afd7ed558ccd);
+    k ^= k >> 33;
+    k *= UINT64_C(0xc4ceb9fe1a85ec53);
+    k ^= k >> 33;
+    return k;
+  };
+  const uint64_t c1 = UINT64_C(0x87c37b91114253d5);
+  const uint64_t c2 = UINT64_C(0x4cf5ad432745937f);
+  auto *bytes = (const unsigned char *)data;
+  size_t nblocks = len / 16;
+  uint64_t h1 = seed, h2 = seed;
+
+  for (size_t i = 0; i < nblocks; ++i) {
+    uint64_t k1, k2;
+    std::memcpy(&k1, bytes + i * 16, 8);
+    std::memcpy(&k2, bytes + i * 16 + 8, 8);
+
+    k1 *= c1; k1 = rotl(k1, 31); k1 *= c2; h1 ^= k1;
+    h1 = rotl(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52dce729;
+    k2 *= c2; k2 = rotl(k2, 33); k2 *= c1; h2 ^= k2;
+    h2 = rotl(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495ab5;
+  }
+
+  const unsigned char *tail = bytes + nblocks * 16;
+  uint64_t k1 = 0, k2 = 0;
+  switch (len & 15) {
+  case 15: k2 ^= uint64_t(tail[14]) << 48; [[fallthrough]];
+  case 14: k2 ^= uint64_t(tail[13]) << 40; [[fallthrough]];
+  case 13: k2 ^= uint64_t(tail[12]) << 32; [[fallthrough]];
+  case 12: k2 ^= uint64_t(tail[11]) << 24; [[fallthrough]];
+  case 11: k2 ^= uint64_t(tail[10]) << 16; [[fallthrough]];
+  case 10: k2 ^= uint64_t(tail[9]) << 8;   [[fallthrough]];
+  case 9:  k2 ^= uint64_t(tail[8]);
+           k2 *= c2; k2 = rotl(k2, 33); k2 *= c1; h2 ^= k2;
+           [[fallthrough]];
+  case 8:  k1 ^= uint64_t(tail[7]) << 56;  [[fallthrough]];
+  case 7:  k1 ^= uint64_t(tail[6]) << 48;  [[fallthrough]];
+  case 6:  k1 ^= uint64_t(tail[5]) << 40;  [[fallthrough]];
+  case 5:  k1 ^= uint64_t(tail[4]) << 32;  [[fallthrough]];
+  case 4:  k1 ^= uint64_t(tail[3]) << 24;  [[fallthrough]];
+  case 3:  k1 ^= uint64_t(tail[2]) << 16;  [[fallthrough]];
+  case 2:  k1 ^= uint64_t(tail[1]) << 8;   [[fallthrough]];
+  case 1:  k1 ^= uint64_t(tail[0]);
+           k1 *= c1; k1 = rotl(k1, 31); k1 *= c2; h1 ^= k1;
+  }
+
+  h1 ^= len; h2 ^= len;
+  h1 += h2; h2 += h1;
+  h1 = fmix(h1); h2 = fmix(h2);
+  h1 += h2; h2 += h1;
+  return { h1, h2 };
+}
+
+inline Hash128 hash128(const std::string &s, uint64_t seed = 0) {
+  return hash128(s.data(), s.size(), seed);
+}
@@ -34,6 +34,10 @@ bool parallel::init() {
   return true;
 }
 
+int parallel::submit(std::function<void(std::ostream &)> &&job) {
+  UNREACHABLE();
+}
+
 void parallel::reapZombies() {
   while (waitpid((pid_t)-1, nullptr, WNOHANG) > 0)
     ;
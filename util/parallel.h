@@ -3,10 +3,16 @@
 // Copyright (c) 2018-present The Alive2 Authors.
 // Distributed under the MIT license that can be found in the LICENSE file.
 
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <ostream>
 #include <poll.h>
 #include <sstream>
 #include <sys/types.h>
+#include <thread>
 #include <tuple>
 #include <vector>
 
@@ -25,25 +31,28 @@ struct childProcess {
 
 class parallel {
   pid_t parent_pid = -1;
-  int max_active_children;
   int fd_to_parent;
   int active_children = 0;
   std::vector<pollfd> pfd;
   std::vector<int> pfd_map;
-  std::vector<childProcess> children;
   std::stringstream &parent_ss;
   std::ostream &out_file;
-  void ensureParent();
   void ensureChild();
   void reapZombies();
-  bool emitOutput();
   bool readFromChildren(bool blocking);
 
+protected:
+  int max_active_children;
+  // a deque so that jobs running in threads keep valid references
+  std::deque<childProcess> children;
+  void ensureParent();
+  bool emitOutput();
+
 public:
   parallel(int max_active_children, std::stringstream &parent_ss,
            std::ostream &out_file)
-      : max_active_children(max_active_children), parent_ss(parent_ss),
-        out_file(out_file) {}
+      : parent_ss(parent_ss), out_file(out_file),
+        max_active_children(max_active_children) {}
   virtual ~parallel() {}
 
   /*
@@ -66,6 +75,20 @@ public:
    */
   virtual std::tuple<pid_t, std::ostream *, int> limitedFork() = 0;
 
+  /*
+   * whether jobs run in child processes (created with limitedFork())
+   * or in threads of this process (created with submit())
+   */
+  virtual bool forks() const { return true; }
+
+  /*
+   * called from parent; queues a job to run in a thread of this
+   * process, which may block to throttle the parent. the job gets an
+   * ostream to write its results into, and the returned integer is a
+   * unique identifier for it, like the one returned by limitedFork()
+   */
+  virtual int submit(std::function<void(std::ostream &)> &&job);
+
   /*
    * called from a child that has finished executing
    */
@@ -119,3 +142,42 @@ public:
   void getToken() override;
   void putToken() override;
 };
+
+/*
+ * runs jobs on a work-stealing pool of max_active_children threads
+ * rather than forking. jobs share the address space with the parent,
+ * so anything they use must be thread safe (e.g., each thread must
+ * create its own SMT context)
+ */
+class threads final : public parallel {
+  struct job {
+    std::function<void(std::ostream &)> fn;
+    childProcess *state;
+  };
+  struct worker {
+    std::mutex m;
+    std::deque<job> queue;
+    std::thread thread;
+  };
+  std::vector<std::unique_ptr<worker>> workers;
+  std::mutex m;
+  std::condition_variable has_work, has_room;
+  unsigned queued = 0, next_worker = 0;
+  bool stop = false;
+  void run(unsigned id);
+  bool pop(unsigned id, job &j);
+
+public:
+  threads(int max_active_children, std::stringstream &parent_ss,
+          std::ostream &out_file)
+      : parallel(max_active_children, parent_ss, out_file) {}
+  ~threads() override;
+  bool init() override;
+  std::tuple<pid_t, std::ostream *, int> limitedFork() override;
+  bool forks() const override { return false; }
+  int submit(std::function<void(std::ostream &)> &&job) override;
+  void finishChild(bool is_timeout) override;
+  void finishParent() override;
+  void getToken() override;
+  void putToken() override;
+};
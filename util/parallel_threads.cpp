@@ -0,0 +1,135 @@
+// Copyright (c) 2018-present The Alive2 Authors.
+// Distributed under the MIT license that can be found in the LICENSE file.
+
+#include "util/compiler.h"
+#include "util/parallel.h"
+#include <cassert>
+
+using namespace std;
+
+bool threads::init() {
+  ENSURE(parallel::init());
+  for (int i = 0; i < max_active_children; ++i)
+    workers.emplace_back(make_unique<worker>());
+  for (unsigned i = 0; i < workers.size(); ++i)
+    workers[i]->thread = thread([this, i] { run(i); });
+  return true;
+}
+
+threads::~threads() {
+  {
+    lock_guard lock(m);
+    stop = true;
+  }
+  has_work.notify_all();
+  for (auto &w : workers)
+    if (w->thread.joinable())
+      w->thread.join();
+}
+
+void threads::getToken() {
+}
+
+void threads::putToken() {
+}
+
+tuple<pid_t, ostream *, int> threads::limitedFork() {
+  // jobs are started with submit()
+  UNREACHABLE();
+}
+
+int threads::submit(function<void(ostream &)> &&fn) {
+  ensureParent();
+  unique_lock lock(m);
+
+  /*
+   * like limitedFork(), throttle the parent: queued jobs hold their
+   * whole transformation in memory
+   */
+  has_room.wait(lock, [&] { return queued < 2 * workers.size(); });
+
+  int index = children.size();
+  childProcess &state = children.emplace_back();
+
+  // workers set eof while holding m, so it's safe to look at it here
+  if (index % 100 == 0)
+    emitOutput();
+
+  /*
+   * round-robin over the workers' queues; idle workers steal from
+   * the others, so a slow job doesn't hold back the ones behind it
+   */
+  auto &w = *workers[next_worker++ % workers.size()];
+  {
+    lock_guard wlock(w.m);
+    w.queue.push_back({ std::move(fn), &state });
+  }
+  ++queued;
+  lock.unlock();
+  has_work.notify_one();
+  return index;
+}
+
+/*
+ * take the newest job from the worker's own queue or steal the oldest
+ * one from another worker. blocks while there's no work; returns false
+ * once the pool is stopped and all jobs were taken
+ */
+bool threads::pop(unsigned id, job &j) {
+  unsigned n = workers.size();
+  while (true) {
+    bool found = false;
+    for (unsigned i = 0; i < n && !found; ++i) {
+      auto &w = *workers[(id + i) % n];
+      lock_guard wlock(w.m);
+      if (w.queue.empty())
+        continue;
+      if (i == 0) {
+        j = std::move(w.queue.back());
+        w.queue.pop_back();
+      } else {
+        j = std::move(w.queue.front());
+        w.queue.pop_front();
+      }
+      found = true;
+    }
+
+    unique_lock lock(m);
+    if (found) {
+      --queued;
+      lock.unlock();
+      has_room.notify_one();
+      return true;
+    }
+    has_work.wait(lock, [&] { return queued > 0 || stop; });
+    if (queued == 0)
+      return false;
+  }
+}
+
+void threads::run(unsigned id) {
+  job j;
+  while (pop(id, j)) {
+    j.fn(j.state->output);
+    j.fn = nullptr; // free whatever the job captured
+    lock_guard lock(m);
+    j.state->eof = true;
+  }
+}
+
+void threads::finishChild(bool is_timeout) {
+  // jobs don't need to do anything special to finish
+}
+
+void threads::finishParent() {
+  ensureParent();
+  {
+    lock_guard lock(m);
+    stop = true;
+  }
+  has_work.notify_all();
+  for (auto &w : workers)
+    w->thread.join();
+  workers.clear();
+  ENSURE(emitOutput());
+}
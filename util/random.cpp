@@ -6,10 +6,10 @@
 
 using namespace std;
 
-static default_random_engine re;
+static thread_local default_random_engine re;
 
 static void seed() {
-  static bool seeded = false;
+  static thread_local bool seeded = false;
   if (!seeded) {
     random_device rd;
     re.seed(rd());